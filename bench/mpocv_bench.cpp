@@ -0,0 +1,586 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+// Headless micro-benchmarks for the render pipeline.
+//
+// Usage: mpocv_bench [--max-points N] [--min-time SEC] [--out FILE]
+//
+// Every case is repeated until it has run for at least --min-time seconds
+// (and at least once). Results are written as one JSON document to stdout,
+// or to FILE when --out is given. No windows are opened.
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "figure.h"
+#include "contour.h"
+#include "histogram.h"
+
+using namespace mpocv;
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Options
+    {
+        double max_points{ 1e8 };   ///< Largest series size to generate.
+        double min_time{ 0.25 };    ///< Minimum wall time per case (seconds).
+        std::string out;            ///< Output file; stdout when empty.
+    };
+
+    struct Result
+    {
+        std::string name;
+        double      points{ 0 };       ///< Points (or items) processed per iteration.
+        long        iterations{ 0 };
+        double      ns_per_iter{ 0 };
+    };
+
+    std::vector<Result> g_results;
+    Options             g_opt;
+
+    /**
+     * Time @p body repeatedly. @p setup runs before every iteration and is not
+     * timed, so each iteration can start from a freshly dirtied figure.
+     */
+    void run_case(const std::string& name, double points,
+        const std::function<void()>& setup, const std::function<void()>& body)
+    {
+        long   iters = 0;
+        double total_ns = 0.0;
+        const auto wall0 = Clock::now();
+        do
+        {
+            setup();
+            const auto t0 = Clock::now();
+            body();
+            const auto t1 = Clock::now();
+            total_ns += std::chrono::duration<double, std::nano>(t1 - t0).count();
+            ++iters;
+        } while (std::chrono::duration<double>(Clock::now() - wall0).count() < g_opt.min_time);
+
+        Result r{ name, points, iters, total_ns / iters };
+        std::cerr << name << " n=" << points << " : " << r.ns_per_iter / 1e6 << " ms/iter\n";
+        g_results.push_back(r);
+    }
+
+    std::vector<double> ramp(size_t n)
+    {
+        std::vector<double> v(n);
+        for (size_t i = 0; i < n; ++i) v[i] = static_cast<double>(i);
+        return v;
+    }
+
+    std::vector<double> wave(size_t n, double f)
+    {
+        std::vector<double> v(n);
+        for (size_t i = 0; i < n; ++i) v[i] = std::sin(f * static_cast<double>(i) / n * 6.283185307179586);
+        return v;
+    }
+
+    std::vector<double> sizes_up_to(double lo, double hi)
+    {
+        std::vector<double> out;
+        for (double n = lo; n <= hi && n <= g_opt.max_points; n *= 10) out.push_back(n);
+        return out;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    void bench_lines()
+    {
+        for (double n : sizes_up_to(1e3, 1e8))
+        {
+            Figure fig(800, 600);
+            fig.plot(ramp(static_cast<size_t>(n)), wave(static_cast<size_t>(n), 7.0), Color::Blue(), 1.0f, "line");
+            run_case("render_line", n, [&] { fig.grid(true); }, [&] { fig.render(); });
+        }
+    }
+
+    void bench_fill_between()
+    {
+        for (double n : sizes_up_to(1e3, 1e8))
+        {
+            const Series x(ramp(static_cast<size_t>(n)));
+            const Series mid(wave(static_cast<size_t>(n), 7.0));
+            std::vector<double> lo(static_cast<size_t>(n)), hi(static_cast<size_t>(n));
+            for (size_t i = 0; i < lo.size(); ++i) { lo[i] = mid[i] - 0.2; hi[i] = mid[i] + 0.2; }
+
+            Figure fig(800, 600);
+            fig.fill_between(x, Series(std::move(lo)), Series(std::move(hi)), ShapeStyle{ Color::Blue(), 0.0f, Color::Blue(), 0.3f }, "band");
+            run_case("render_fill_between", n, [&] { fig.grid(true); }, [&] { fig.render(); });
+        }
+    }
+
+    void bench_line_matrix()
+    {
+        for (int channels : { 64, 512 })
+        {
+            for (double n : sizes_up_to(1e3, 1e6))
+            {
+                if (n * channels > g_opt.max_points) break;
+                const std::vector<double> x = ramp(static_cast<size_t>(n));
+                cv::Mat Y(channels, static_cast<int>(n), CV_32FC1);
+                for (int k = 0; k < channels; ++k)
+                    for (int i = 0; i < Y.cols; ++i) Y.at<float>(k, i) = static_cast<float>(k + std::sin(i * 0.01 * (1 + k % 7)));
+
+                Figure fig(800, 600);
+                fig.plot_matrix(x, Y);
+                run_case("render_line_matrix_" + std::to_string(channels), n * channels, [&] { fig.grid(true); }, [&] { fig.render(); });
+            }
+        }
+    }
+
+    void bench_scatter()
+    {
+        for (double n : sizes_up_to(1e3, 1e6))
+        {
+            Figure fig(800, 600);
+            fig.scatter(wave(static_cast<size_t>(n), 3.0), wave(static_cast<size_t>(n), 5.0), Color::Red(), 3.0f, "pts");
+            run_case("render_scatter", n, [&] { fig.grid(true); }, [&] { fig.render(); });
+        }
+    }
+
+    void bench_translucent_shapes()
+    {
+        for (double n : { 10.0, 100.0, 1000.0 })
+        {
+            Figure fig(800, 600);
+            ShapeStyle s{ Color::Black(), 1.0f, Color::Cyan(), 0.4f };
+            for (int i = 0; i < static_cast<int>(n); ++i)
+            {
+                const double t = i * 0.37;
+                switch (i % 4)
+                {
+                case 0: fig.circle(std::cos(t), std::sin(t), 0.1, s); break;
+                case 1: fig.rect_xywh(std::cos(t), std::sin(t), 0.2, 0.1, s); break;
+                case 2: fig.rotated_rect(std::cos(t), std::sin(t), 0.2, 0.1, 30.0, s); break;
+                default: fig.ellipse(std::cos(t), std::sin(t), 0.2, 0.1, 45.0, s); break;
+                }
+            }
+            run_case("render_translucent_shapes", n, [&] { fig.grid(true); }, [&] { fig.render(); });
+        }
+    }
+
+    void bench_canvas_format()
+    {
+        const std::pair<const char*, CanvasFormat> formats[] = {
+            { "bgr8", CanvasFormat::BGR8 }, { "gray8", CanvasFormat::GRAY8 },
+            { "bgra8", CanvasFormat::BGRA8 }, { "bgr16", CanvasFormat::BGR16 } };
+        const double n = std::min(1e5, g_opt.max_points);
+        for (const auto& fm : formats)
+        {
+            Figure fig(800, 600);
+            fig.canvas_format(fm.second);
+            fig.plot(ramp(static_cast<size_t>(n)), wave(static_cast<size_t>(n), 7.0), Color::Blue(), 1.0f, "line");
+            ShapeStyle s{ Color::Black(), 1.0f, Color::Cyan(), 0.4f };
+            for (int i = 0; i < 100; ++i) fig.circle(std::cos(i * 0.37), std::sin(i * 0.37), 0.1, s);
+            run_case(std::string("render_format_") + fm.first, n, [&] { fig.grid(true); }, [&] { fig.render(); });
+        }
+    }
+
+    void bench_quality()
+    {
+        const std::pair<const char*, RenderQuality> levels[] = {
+            { "draft", RenderQuality::Draft }, { "normal", RenderQuality::Normal }, { "final", RenderQuality::Final } };
+        const double n = std::min(1e5, g_opt.max_points);
+        for (const auto& lv : levels)
+        {
+            Figure fig(800, 600);
+            fig.render_quality(lv.second);
+            fig.plot(ramp(static_cast<size_t>(n)), wave(static_cast<size_t>(n), 7.0), Color::Blue(), 1.0f, "line");
+            fig.scatter(wave(1000, 3.0), wave(1000, 5.0), Color::Red(), 3.0f, "pts");
+            ShapeStyle s{ Color::Black(), 1.0f, Color::Cyan(), 0.4f };
+            for (int i = 0; i < 100; ++i) fig.circle(std::cos(i * 0.37), std::sin(i * 0.37), 0.1, s);
+            run_case(std::string("render_quality_") + lv.first, n, [&] { fig.grid(true); }, [&] { fig.render(); });
+        }
+    }
+
+    /* one frame of the interactive viewer: pan at Draft quality, show the first progressive pass */
+    void bench_interactive_frame()
+    {
+        for (double n : sizes_up_to(1e6, 1e8))
+        {
+            Figure fig(800, 600);
+            fig.plot(ramp(static_cast<size_t>(n)), wave(static_cast<size_t>(n), 7.0), Color::Blue(), 1.0f, "line");
+            fig.render_quality(RenderQuality::Draft);
+            double shift = 0.0;
+            run_case("interactive_pan_frame", n,
+                [&] { shift = shift > 0.2 * n ? 0.0 : shift + 0.01 * n; fig.set_xlim(shift, 0.5 * n + shift); fig.set_ylim(-1.1, 1.1); },
+                [&] { RenderProgress p; do p = fig.render_progressive(15.0); while (!p.complete && p.pass == 0); });
+        }
+    }
+
+    /* first pick builds the spatial index; later picks only query it */
+    void bench_pick()
+    {
+        for (double n : sizes_up_to(1e4, 1e7))
+        {
+            const std::vector<double> xs = wave(static_cast<size_t>(n), 3.0), ys = wave(static_cast<size_t>(n), 5.0);
+            std::unique_ptr<Figure> fig;
+            run_case("pick_index_build", n,
+                [&] { fig = std::make_unique<Figure>(800, 600); fig->scatter(xs, ys, Color::Red(), 3.0f, "pts"); },
+                [&] { fig->pick(400, 300); });
+
+            int px = 60;
+            run_case("pick_query", n,
+                [&] { px = px >= 760 ? 60 : px + 7; },
+                [&] { fig->pick(px, 300); });
+        }
+    }
+
+    /* producer threads push samples through the feed while this thread renders frames */
+    void bench_feed()
+    {
+        constexpr int kProducers = 4;
+        for (double n : sizes_up_to(1e5, 1e7))
+        {
+            Figure fig(800, 600);
+            fig.memory_budget(64u << 20, MemoryPolicy::DropOldest);
+            auto feed = fig.feed(1 << 16);
+            int streams[kProducers];
+            for (int p = 0; p < kProducers; ++p) streams[p] = fig.add_stream(Color::Blue(), 1.0f, "ch" + std::to_string(p));
+
+            const size_t per = static_cast<size_t>(n) / kProducers;
+            run_case("feed_push_render", n, [&] {}, [&]
+                {
+                    std::atomic<int> running{ kProducers };
+                    std::vector<std::thread> producers;
+                    for (int p = 0; p < kProducers; ++p)
+                        producers.emplace_back([&, p]
+                            {
+                                for (size_t i = 0; i < per; ++i) feed->push(streams[p], static_cast<double>(i), std::sin(i * 1e-3) + p);
+                                --running;
+                            });
+                    while (running.load() > 0) fig.render();
+                    for (auto& t : producers) t.join();
+                    fig.render();
+                });
+            std::cerr << "  dropped " << feed->dropped_samples() << " samples\n";
+        }
+    }
+
+    void bench_image()
+    {
+        for (int side : { 256, 1024, 4096 })
+        {
+            if (static_cast<double>(side) * side > g_opt.max_points) break;
+            cv::Mat grid(side, side, CV_32FC1);
+            for (int r = 0; r < side; ++r)
+                for (int c = 0; c < side; ++c) grid.at<float>(r, c) = static_cast<float>(std::sin(r * 0.01) * std::cos(c * 0.013));
+            const double n = static_cast<double>(side) * side;
+
+            Figure fig(800, 600);
+            fig.image(grid, Colormap::Viridis, 0.0, 0.0, ImageInterp::Bilinear);
+            run_case("render_image_cached", n, [&] { fig.grid(true); }, [&] { fig.render(); });
+
+            /* every iteration pans, so the colorized pixels are rebuilt */
+            double shift = 0.0;
+            run_case("render_image_pan", n,
+                [&] { shift = shift > 10.0 ? 0.0 : shift + 1.0; fig.set_xlim(shift, side + shift); fig.set_ylim(0, side); },
+                [&] { fig.render(); });
+        }
+    }
+
+    void bench_contour()
+    {
+        for (int side : { 256, 1024, 4096 })
+        {
+            if (static_cast<double>(side) * side > g_opt.max_points) break;
+            cv::Mat grid(side, side, CV_32FC1);
+            for (int r = 0; r < side; ++r)
+                for (int c = 0; c < side; ++c) grid.at<float>(r, c) = static_cast<float>(std::sin(r * 0.01) * std::cos(c * 0.013));
+            const std::vector<double> levels = { -0.75, -0.5, -0.25, 0.0, 0.25, 0.5, 0.75 };
+            const double n = static_cast<double>(side) * side;
+
+            run_case("contour_extract", n, [&] {}, [&] { extract_contours(grid, levels); });
+            Figure shown(800, 600);
+            shown.contour(grid, levels);
+            run_case("render_contour", n, [&] { shown.grid(true); }, [&] { shown.render(); });
+        }
+    }
+
+    void bench_hist()
+    {
+        for (double n : sizes_up_to(1e6, 1e8))
+        {
+            const Series data(wave(static_cast<size_t>(n), 7.0));
+            std::vector<uint64_t> counts;
+            run_case("hist_bin", n, [&] {}, [&] { histogram_counts(data, -1.0, 1.0, 100, counts); });
+
+            /* every iteration moves the x-limits, so the shared samples are re-binned */
+            Figure fig(800, 600);
+            fig.hist(data, 100);
+            double shift = 0.0;
+            run_case("render_hist_rebin", n,
+                [&] { shift = shift > 0.5 ? 0.0 : shift + 0.05; fig.set_xlim(-1.0 + shift, 1.0 + shift); fig.set_ylim(0, n / 20); },
+                [&] { fig.render(); });
+        }
+    }
+
+    void bench_text()
+    {
+        for (double n : { 100.0, 1000.0, 10000.0 })
+        {
+            Figure fig(800, 600);
+            for (int i = 0; i < static_cast<int>(n); ++i)
+                fig.text(std::cos(i * 0.1) * i, std::sin(i * 0.1) * i, "label " + std::to_string(i));
+            fig.title("Text heavy");
+            fig.xlabel("x");
+            fig.ylabel("y");
+            run_case("render_text", n, [&] { fig.grid(true); }, [&] { fig.render(); });
+        }
+    }
+
+    void bench_ticks()
+    {
+        const int kCalls = 10000;
+        run_case("make_ticks", kCalls, [] {}, [&]
+            {
+                for (int i = 0; i < kCalls; ++i)
+                {
+                    volatile size_t sink = Figure::make_ticks(-1.0 - i * 1e-3, 3.7 + i * 1e-2).locs.size();
+                    (void)sink;
+                }
+            });
+    }
+
+    void bench_expand_bounds()
+    {
+        for (double n : sizes_up_to(1e3, 1e7))
+        {
+            const std::vector<double> x = ramp(static_cast<size_t>(n));
+            const std::vector<double> y = wave(static_cast<size_t>(n), 2.0);
+            std::vector<double> xi, yi;
+            // plot() with moved vectors costs one bounds pass and no copy
+            run_case("expand_bounds", n, [&] { xi = x; yi = y; }, [&]
+                {
+                    Figure fig(64, 64);
+                    fig.plot(std::move(xi), std::move(yi));
+                });
+        }
+    }
+
+    void bench_save()
+    {
+        const auto dir = std::filesystem::temp_directory_path();
+        Figure fig(800, 600);
+        fig.plot(ramp(10000), wave(10000, 7.0), Color::Blue(), 1.0f, "line");
+        fig.grid(true);
+        fig.legend();
+        fig.render();
+        for (const char* ext : { ".png", ".jpg" })
+        {
+            const std::string path = (dir / (std::string("mpocv_bench") + ext)).string();
+            run_case(std::string("save") + ext, 800.0 * 600.0, [] {}, [&] { fig.save(path); });
+            std::remove(path.c_str());
+        }
+    }
+
+    /* in-memory encode into one reused buffer, per format and effort setting */
+    void bench_encode()
+    {
+        Figure fig(800, 600);
+        fig.plot(ramp(10000), wave(10000, 7.0), Color::Blue(), 1.0f, "line");
+        fig.grid(true);
+        fig.legend();
+        fig.render();
+        std::vector<uint8_t> out;
+        const std::pair<const char*, EncodeParams> cases[] = {
+            { "png_level1", EncodeParams{ 1 } }, { "png_level6", EncodeParams{ 6 } },
+            { "jpg_q80", EncodeParams{ -1, 80 } }, { "webp_q80", EncodeParams{ -1, -1, false, false, 80 } } };
+        for (const auto& c : cases)
+        {
+            const std::string format = std::string(c.first).substr(0, std::string(c.first).find('_'));
+            run_case(std::string("encode_") + c.first, 800.0 * 600.0, [] {}, [&] { fig.encode(format, out, c.second); });
+            std::cerr << "  " << out.size() << " bytes\n";
+        }
+    }
+
+#ifndef _WIN32
+    /* one frame into the shared-memory ring, alone and with a reader copying frames concurrently */
+    void bench_shm_publish()
+    {
+        const cv::Mat frame(600, 800, CV_8UC3, cv::Scalar(255, 255, 255));
+        const std::string name = "mpocv_bench_" + std::to_string(static_cast<long>(getpid()));
+        auto pub = ShmPublisher::create(name, frame.total() * frame.elemSize());
+        if (!pub) return;
+        run_case("shm_publish_800x600", 800.0 * 600.0, [] {}, [&] { pub->publish(frame); });
+
+        std::atomic<bool> stop{ false };
+        uint64_t read = 0;
+        std::thread viewer([&] {
+            auto reader = ShmReader::open(name);
+            cv::Mat out;
+            for (uint64_t seen = 0; reader && !stop.load();)
+                if (const uint64_t f = reader->read_latest(out, seen)) { seen = f; ++read; }
+        });
+        run_case("shm_publish_800x600_reader", 800.0 * 600.0, [] {}, [&] { pub->publish(frame); });
+        stop.store(true);
+        viewer.join();
+        std::cerr << "  reader copied " << read << " of " << pub->frames() << " frames\n";
+    }
+#endif
+
+    /* animated frame encoded to JPEG: serially, and with the encode of frame N overlapping the render of N + 1 */
+    void bench_double_buffer()
+    {
+        const size_t n = static_cast<size_t>(std::min(1e6, g_opt.max_points));
+        const std::vector<int> params{ cv::IMWRITE_JPEG_QUALITY, 90 };
+        std::vector<uchar> bytes;
+        for (int buffers : { 1, 2 })
+        {
+            Figure fig(800, 600);
+            fig.plot(ramp(n), wave(n, 7.0), Color::Blue(), 1.0f, "line");
+            fig.buffer_count(buffers);
+            double shift = 0.0;
+            auto next_view = [&] { shift = shift > 0.2 * n ? 0.0 : shift + 0.01 * n; fig.set_xlim(shift, 0.5 * n + shift); fig.set_ylim(-1.1, 1.1); };
+            if (buffers == 1)
+            {
+                run_case("frame_encode_serial", static_cast<double>(n), next_view,
+                    [&] { fig.render(); cv::imencode(".jpg", fig.front(), bytes, params); });
+            }
+            else
+            {
+                fig.render();
+                run_case("frame_encode_overlapped", static_cast<double>(n), next_view, [&]
+                    {
+                        fig.swap_buffers();
+                        const cv::Mat frame = fig.front();
+                        std::thread worker([&] { fig.render(); });
+                        cv::imencode(".jpg", frame, bytes, params);
+                        worker.join();
+                    });
+            }
+        }
+    }
+
+    /**
+     * Per-frame figure life cycle: build thousands of annotation commands and
+     * destroy the figure again, with the default heap and with a monotonic
+     * arena that is released in one shot. Rendering is identical in both
+     * cases and is left out.
+     */
+    void bench_frame_alloc()
+    {
+        const int kAnnotations = 2000;
+        std::vector<std::string> msgs, labels;
+        for (int i = 0; i < kAnnotations; ++i)
+        {
+            msgs.push_back("annotation number " + std::to_string(i));
+            labels.push_back("polygon label " + std::to_string(i));
+        }
+        const std::vector<double> px{ 0.0, 1.0, 1.0, 0.0 }, py{ 0.0, 0.0, 1.0, 1.0 };
+        const ShapeStyle s{ Color::Black(), 1.0f, Color::Cyan(), 1.0f };
+
+        auto build = [&](std::pmr::memory_resource* mr)
+            {
+                Figure fig(800, 600, mr);
+                for (int i = 0; i < kAnnotations; ++i)
+                {
+                    fig.text(i, i, msgs[i]);
+                    fig.polygon(px, py, s, labels[i]);
+                }
+            };
+
+        run_case("frame_build_heap", 2.0 * kAnnotations, [] {}, [&] { build(std::pmr::get_default_resource()); });
+
+        std::vector<std::byte> arena_buf(size_t(16) << 20);
+        run_case("frame_build_arena", 2.0 * kAnnotations, [] {}, [&]
+            {
+                std::pmr::monotonic_buffer_resource arena(arena_buf.data(), arena_buf.size());
+                build(&arena);
+            });
+    }
+
+    /* ---------------------------------------------------------------------- */
+    void write_json(std::ostream& os)
+    {
+        os << "{\n  \"benchmark\": \"mpocv_bench\",\n  \"results\": [\n";
+        for (size_t i = 0; i < g_results.size(); ++i)
+        {
+            const Result& r = g_results[i];
+            os << "    { \"name\": \"" << r.name << "\""
+               << ", \"points\": " << static_cast<long long>(r.points)
+               << ", \"iterations\": " << r.iterations
+               << ", \"ns_per_iter\": " << r.ns_per_iter
+               << ", \"ns_per_point\": " << r.ns_per_iter / r.points
+               << ", \"frames_per_s\": " << 1e9 / r.ns_per_iter
+               << " }" << (i + 1 < g_results.size() ? "," : "") << "\n";
+        }
+        os << "  ]\n}\n";
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string a = argv[i];
+        if (a == "--max-points" && i + 1 < argc)    g_opt.max_points = std::stod(argv[++i]);
+        else if (a == "--min-time" && i + 1 < argc) g_opt.min_time = std::stod(argv[++i]);
+        else if (a == "--out" && i + 1 < argc)      g_opt.out = argv[++i];
+        else
+        {
+            std::cerr << "usage: mpocv_bench [--max-points N] [--min-time SEC] [--out FILE]\n";
+            return 1;
+        }
+    }
+
+    bench_lines();
+    bench_fill_between();
+    bench_line_matrix();
+    bench_scatter();
+    bench_translucent_shapes();
+    bench_quality();
+    bench_canvas_format();
+    bench_interactive_frame();
+    bench_pick();
+    bench_feed();
+    bench_image();
+    bench_contour();
+    bench_hist();
+    bench_text();
+    bench_ticks();
+    bench_expand_bounds();
+    bench_save();
+    bench_encode();
+#ifndef _WIN32
+    bench_shm_publish();
+#endif
+    bench_double_buffer();
+    bench_frame_alloc();
+
+    if (g_opt.out.empty())
+    {
+        write_json(std::cout);
+    }
+    else
+    {
+        std::ofstream f(g_opt.out);
+        write_json(f);
+    }
+    return 0;
+}
@@ -0,0 +1,30 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#pragma once
+#include <cstdint>
+
+namespace mpocv
+{
+
+    /**
+     * @enum CanvasFormat
+     * @brief Pixel format of a Figure's canvas (see Figure::canvas_format()).
+     *
+     * Every primitive is drawn directly in the selected format; colors are
+     * converted once per draw call, not per pixel and not after rendering.
+     */
+    enum class CanvasFormat : uint8_t
+    {
+        BGR8,   ///< CV_8UC3 on white (default).
+        GRAY8,  ///< CV_8UC1 on white; colors become their luma (Rec. 601).
+        BGRA8,  ///< CV_8UC4 on transparent black, premultiplied alpha; for compositing over video.
+        BGR16   ///< CV_16UC3 on white; 8-bit colors scaled by 257. Anti-aliasing falls back to 8-connected lines.
+    };
+
+} // namespace mpocv
@@ -0,0 +1,47 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#pragma once
+#include <cstdint>
+#include "color.h"
+
+namespace mpocv
+{
+
+    /**
+     * @enum Colormap
+     * @brief Built-in 256-entry color lookup tables.
+     */
+    enum class Colormap : uint8_t
+    {
+        Viridis,   ///< Perceptually uniform, dark blue to yellow.
+        Jet,       ///< Blue - cyan - yellow - red.
+        Gray,      ///< Black to white.
+        Tab10      ///< Ten categorical colors, repeated (index i -> color i % 10).
+    };
+
+    /**
+     * @brief 256-entry lookup table of @p map.
+     *
+     * Tables are built once on first use and stay valid for the lifetime of
+     * the program.
+     *
+     * @return const Color* Pointer to 256 colors.
+     */
+    const Color* colormap_lut(Colormap map);
+
+    /**
+     * @brief Color of @p map at position @p t in [0, 1] (clamped).
+     */
+    inline Color colormap_color(Colormap map, double t)
+    {
+        t = t < 0.0 ? 0.0 : (t > 1.0 ? 1.0 : t);
+        return colormap_lut(map)[static_cast<int>(t * 255.0 + 0.5)];
+    }
+
+} // namespace mpocv
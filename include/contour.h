@@ -0,0 +1,48 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#pragma once
+#include <opencv2/core.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace mpocv
+{
+
+    /**
+     * @brief Iso-line segments of a scalar grid, in grid coordinates.
+     *
+     * Sample (r, c) of the grid sits at (x, y) = (c, r). Segment k runs from
+     * (x[2k], y[2k]) to (x[2k+1], y[2k+1]). Segments are grouped by level:
+     * those of level i are k in [level_begin[i], level_begin[i + 1]).
+     */
+    struct ContourSegments
+    {
+        std::vector<float>  x, y;          ///< Segment end points (two per segment).
+        std::vector<size_t> level_begin;   ///< First segment of each level, plus the total.
+
+        size_t size() const { return x.size() / 2; }
+    };
+
+    /**
+     * @brief Extract iso-lines of @p grid at each of @p levels (marching squares).
+     *
+     * Row bands of the grid are processed in parallel with cv::parallel_for_,
+     * each band into its own buffers, which are concatenated in row order, so
+     * the result does not depend on the thread count. Saddle cells are
+     * resolved with the cell average; cells with a non-finite corner are skipped.
+     *
+     * @param grid   Single-channel matrix of any depth (non-float depths are
+     *               converted to float first).
+     * @param levels Iso-values.
+     * @return ContourSegments Empty if @p grid is not single-channel or smaller than 2 x 2.
+     */
+    ContourSegments extract_contours(const cv::Mat& grid, const std::vector<double>& levels);
+
+} // namespace mpocv
@@ -0,0 +1,118 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "series.h"
+
+namespace mpocv
+{
+
+    /**
+     * @brief Point in output (pixel) space, kept in floating point.
+     */
+    struct PixelPoint
+    {
+        double x{ 0.0 };
+        double y{ 0.0 };
+    };
+
+    /**
+     * @brief Stream a poly-line reduced to at most four points per output column.
+     *
+     * Consecutive samples that fall into the same pixel column are collapsed
+     * to their first, minimum-y, maximum-y and last point (in sample order),
+     * which draws exactly the same pixels as the full run. Works in a single
+     * pass with O(1) memory, so it can feed a writer directly.
+     *
+     * Runs are formed from consecutive samples only, so non-monotonic x data
+     * is still drawn correctly (it just collapses less).
+     *
+     * @param x       X samples.
+     * @param y       Y samples (same length as @p x).
+     * @param to_px   Callable mapping (x, y) data to a PixelPoint.
+     * @param emit    Callable receiving the kept PixelPoints in path order.
+     * @return size_t Number of points emitted.
+     */
+    template<typename ToPixel, typename Emit>
+    size_t decimate_min_max(const Series& x, const Series& y, ToPixel&& to_px, Emit&& emit)
+    {
+        const size_t n = std::min(x.size(), y.size());
+        if (n == 0) return 0;
+
+        size_t emitted = 0;
+        PixelPoint first = to_px(x[0], y[0]);
+        PixelPoint lo = first, hi = first, last = first;
+        size_t i_lo = 0, i_hi = 0, i_last = 0;
+        double column = std::floor(first.x);
+
+        auto flush = [&]()
+            {
+                /* first is always index 0 of the run; order the interior extrema by index */
+                emit(first); ++emitted;
+                const PixelPoint* a = i_lo <= i_hi ? &lo : &hi;
+                const PixelPoint* b = i_lo <= i_hi ? &hi : &lo;
+                const size_t ia = i_lo <= i_hi ? i_lo : i_hi;
+                const size_t ib = i_lo <= i_hi ? i_hi : i_lo;
+                if (ia != 0 && ia != i_last) { emit(*a); ++emitted; }
+                if (ib != 0 && ib != i_last && ib != ia) { emit(*b); ++emitted; }
+                if (i_last != 0) { emit(last); ++emitted; }
+            };
+
+        size_t run = 0;   /* index of the current sample within its run */
+        for (size_t i = 1; i < n; ++i)
+        {
+            const PixelPoint p = to_px(x[i], y[i]);
+            const double c = std::floor(p.x);
+            if (c != column)
+            {
+                flush();
+                first = lo = hi = last = p;
+                i_lo = i_hi = i_last = 0;
+                column = c;
+                run = 0;
+                continue;
+            }
+            ++run;
+            if (p.y < lo.y) { lo = p; i_lo = run; }
+            if (p.y > hi.y) { hi = p; i_hi = run; }
+            last = p; i_last = run;
+        }
+        flush();
+        return emitted;
+    }
+
+    /**
+     * @brief Closed pixel outline of the band between two curves over shared x.
+     *
+     * The @p y_hi curve is walked forward and the @p y_lo curve backward, each
+     * reduced with decimate_min_max(), so the outline is built straight from
+     * the three series without concatenating them in data space first.
+     *
+     * @param x     X samples.
+     * @param y_lo  Lower curve (same length as @p x).
+     * @param y_hi  Upper curve (same length as @p x).
+     * @param to_px Callable mapping (x, y) data to a PixelPoint.
+     * @param out   Receives the outline (cleared first; capacity is reused).
+     */
+    template<typename ToPixel>
+    void band_outline(const Series& x, const Series& y_lo, const Series& y_hi, ToPixel&& to_px, std::vector<PixelPoint>& out)
+    {
+        out.clear();
+        auto push = [&out](const PixelPoint& p) { out.push_back(p); };
+        decimate_min_max(x, y_hi, to_px, push);
+        const size_t upper = out.size();
+        decimate_min_max(x, y_lo, to_px, push);
+        std::reverse(out.begin() + static_cast<std::ptrdiff_t>(upper), out.end());
+    }
+
+} // namespace mpocv
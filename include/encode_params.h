@@ -0,0 +1,32 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#pragma once
+
+namespace mpocv
+{
+
+    /**
+     * @struct EncodeParams
+     * @brief Encoder settings for Figure::encode() and Figure::save().
+     *
+     * Only the fields of the chosen format are used. A negative value keeps
+     * the OpenCV default for that setting. Lower PNG levels and JPEG / WebP
+     * qualities trade output size for encode time.
+     */
+    struct EncodeParams
+    {
+        int  png_compression{ -1 };     ///< PNG zlib level 0 (fastest) .. 9 (smallest); OpenCV default 1.
+        int  jpeg_quality{ -1 };        ///< JPEG quality 0 .. 100; OpenCV default 95.
+        bool jpeg_progressive{ false }; ///< Write progressive JPEG.
+        bool jpeg_optimize{ false };    ///< Optimize JPEG Huffman tables (smaller, slower).
+        int  webp_quality{ -1 };        ///< WebP quality 1 .. 100, above 100 lossless; OpenCV default lossless.
+        bool final_quality{ true };     ///< Render at RenderQuality::Final first; false encodes at the current quality.
+    };
+
+} // namespace mpocv
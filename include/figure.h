@@ -14,22 +14,42 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <iomanip>
 #include <limits>
+#include <memory>
+#include <memory_resource>
 #include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "color.h"
+#include "decimate.h"
+#include "figure_feed.h"
+#include "mjpeg_server.h"
 #include "plot_command.h"   // already defines CmdType
+#include "series.h"
 #include "axes.h"
+#include "canvas_format.h"
+#include "encode_params.h"
+#include "render_stats.h"
+#include "memory_usage.h"
+#include "pick_result.h"
+#include "render_quality.h"
+#include "render_progress.h"
+#include "shm_ring.h"
+#include "spatial_grid.h"
 
 namespace mpocv
 {
     /* --------------------------------------------------------------------------
      * Forward-declarations
      * ------------------------------------------------------------------------*/
+    class RecordWriter;
+    class RecordReader;
+    class SvgWriter;
+
     struct TickInfo
     {
         std::vector<double>        locs;   ///< Tick locations in data space.
@@ -66,10 +86,12 @@ namespace mpocv
      *   - a pixel buffer (cv::Mat)
      *   - an Axes object describing the data coordinate system
      *   - a vector of PlotCommand structs
+     *   - optionally, a grid of subplot Figures that draw into ROIs of the canvas
      *
      * Thread safety: concurrent access to a single Figure must be guarded by
      * the caller. Separate Figure instances can be used from different threads
-     * without locking.
+     * without locking. To feed one figure from several threads while another
+     * renders it, producers go through feed() (see FigureFeed).
      */
     class Figure
     {
@@ -81,8 +103,27 @@ namespace mpocv
          *
          * @param w Canvas width in pixels. Defaults to 640.
          * @param h Canvas height in pixels. Defaults to 480.
+         * @param mr Memory resource for the command list, labels, text strings and
+         *           copied series data (e.g. a std::pmr::monotonic_buffer_resource
+         *           for per-frame figures). It must outlive the figure and any copy
+         *           of it. Series moved in through the rvalue overloads keep their
+         *           own buffers.
+         */
+        Figure(int w = 640, int h = 480,
+            std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+
+        /**
+         * @brief Copy the plot: commands (sharing their point buffers), axes, styling and canvas.
+         *
+         * Endpoints bound to one figure stay with @p other: the copy starts
+         * without its MJPEG server (stream_mjpeg()), shared-memory ring
+         * (publish_shm()) and producer feed (feed()); call those on the copy
+         * to give it its own. Copy assignment keeps the target's endpoints.
          */
-        Figure(int w = 640, int h = 480);
+        Figure(const Figure& other) = default;
+        Figure& operator=(const Figure& other) = default;
+        Figure(Figure&&) = default;
+        Figure& operator=(Figure&&) = default;
 
 
         // ========================================================================
@@ -123,6 +164,24 @@ namespace mpocv
             float thickness = 1.f,
             const std::string& label = "");
 
+        /**
+         * @brief Draw a connected poly-line from Series (shares the buffers).
+         *
+         * Accepts views returned by load_npy() / load_raw(). For views the
+         * data bounds are not scanned here but on the first autoscaling
+         * render, so no page of a mapped file is touched before then.
+         *
+         * @param x Series of x data values.
+         * @param y Series of y data values (must be the same length as @p x).
+         * @param c Line color. Defaults to blue.
+         * @param thickness Line thickness in pixels.
+         */
+        void plot(const Series& x,
+            const Series& y,
+            Color c = Color::Blue(),
+            float thickness = 1.f,
+            const std::string& label = "");
+
         /**
          * @brief Draw unconnected markers (lvalue overload).
          *
@@ -155,6 +214,237 @@ namespace mpocv
             float marker_size = 4.f,
             const std::string& label = "");
 
+        /**
+         * @brief Draw unconnected markers from Series (shares the buffers).
+         *
+         * @param x Series of x data values.
+         * @param y Series of y data values (must be the same length as @p x).
+         * @param c Marker color. Defaults to red.
+         * @param marker_size Size of the markers.
+         */
+        void scatter(const Series& x,
+            const Series& y,
+            Color c = Color::Red(),
+            float marker_size = 4.f,
+            const std::string& label = "");
+
+        /**
+         * @brief Draw markers colored by value through a colormap, in one command.
+         *
+         * Values are mapped linearly from [vmin, vmax] onto the 256-entry
+         * LUT of @p cmap and stored as one byte per point. When vmin >= vmax
+         * the finite range of @p values is used. The whole set renders in a
+         * single pass and produces one legend entry. Nothing is added when
+         * @p y, @p values or a non-empty @p sizes differ in length from @p x.
+         *
+         * @param x      Vector of x data values.
+         * @param y      Vector of y data values (must be the same length as @p x).
+         * @param values Per-point color values (same length as @p x).
+         * @param sizes  Per-point marker radii in pixels (same length as @p x); empty for 4 px.
+         * @param cmap   Colormap. Defaults to Viridis.
+         * @param vmin   Value mapped to the first LUT entry.
+         * @param vmax   Value mapped to the last LUT entry.
+         */
+        void scatter_colored(const std::vector<double>& x,
+            const std::vector<double>& y,
+            const std::vector<double>& values,
+            const std::vector<double>& sizes = {},
+            Colormap cmap = Colormap::Viridis,
+            double vmin = 0.0,
+            double vmax = 0.0,
+            const std::string& label = "");
+
+        /**
+         * @brief Draw markers colored by class index, in one command.
+         *
+         * Class i uses LUT entry i % 256; with the default Tab10 map this
+         * cycles through ten distinct colors. Nothing is added when @p y,
+         * @p classes or a non-empty @p sizes differ in length from @p x.
+         *
+         * @param x       Vector of x data values.
+         * @param y       Vector of y data values (must be the same length as @p x).
+         * @param classes Per-point class indices (same length as @p x).
+         * @param sizes   Per-point marker radii in pixels (same length as @p x); empty for 4 px.
+         * @param cmap    Colormap. Defaults to Tab10.
+         */
+        void scatter_classes(const std::vector<double>& x,
+            const std::vector<double>& y,
+            const std::vector<int>& classes,
+            const std::vector<double>& sizes = {},
+            Colormap cmap = Colormap::Tab10,
+            const std::string& label = "");
+
+        /**
+         * @brief Draw a 2-D grid of scalars (heat map, cost map, spectrogram) into a data extent.
+         *
+         * The values are copied once (8-bit, float and double grids keep their
+         * element type; other depths are stored as float). At render time only
+         * the visible cells are resampled to the plot resolution in one
+         * cv::warpAffine (preceded by an area cv::resize when bilinear
+         * sampling shrinks the grid) and colorized with cv::applyColorMap.
+         * The colorized pixels are cached until the axes or the canvas change.
+         * Draft quality always samples nearest.
+         *
+         * Row 0 is drawn at the top of the extent, cell (r, c) covers
+         * [x0 + c * w, x0 + (c + 1) * w] with w = (x1 - x0) / cols.
+         *
+         * @param values Single-channel matrix; other inputs are ignored.
+         * @param x0     Left edge of the first column (data units).
+         * @param y0     Bottom edge of the last row.
+         * @param x1     Right edge of the last column.
+         * @param y1     Top edge of the first row.
+         * @param cmap   Colormap. Defaults to Viridis.
+         * @param vmin   Value mapped to the first LUT entry.
+         * @param vmax   Value mapped to the last LUT entry; when vmin >= vmax the
+         *               finite range of @p values is used.
+         * @param interp Nearest (flat cells) or Bilinear.
+         */
+        void image(const cv::Mat& values,
+            double x0, double y0, double x1, double y1,
+            Colormap cmap = Colormap::Viridis,
+            double vmin = 0.0,
+            double vmax = 0.0,
+            ImageInterp interp = ImageInterp::Nearest,
+            const std::string& label = "");
+
+        /**
+         * @brief Draw a 2-D grid of scalars with one data unit per cell.
+         *
+         * Same as the extent overload with [0, cols] x [0, rows].
+         */
+        void image(const cv::Mat& values,
+            Colormap cmap = Colormap::Viridis,
+            double vmin = 0.0,
+            double vmax = 0.0,
+            ImageInterp interp = ImageInterp::Nearest,
+            const std::string& label = "");
+
+        /**
+         * @brief Draw iso-lines of a 2-D grid of scalars at the given levels.
+         *
+         * The segments are extracted once, here, with a row-parallel marching
+         * squares pass (see extract_contours()) and kept as one segment
+         * collection command in float grid coordinates (16 bytes per segment).
+         * Level i gets colormap entry i * 255 / (levels - 1), so a single
+         * level uses the first entry (black with Colormap::Gray).
+         *
+         * Sample (r, c) sits at the centre of the cell image() draws for it
+         * with the same extent, so contours overlay a heat map of the grid.
+         *
+         * @param grid      Single-channel matrix; other inputs are ignored.
+         * @param levels    Iso-values.
+         * @param x0        Left edge of the first column (data units).
+         * @param y0        Bottom edge of the last row.
+         * @param x1        Right edge of the last column.
+         * @param y1        Top edge of the first row.
+         * @param cmap      Colormap for the levels. Defaults to Viridis.
+         * @param thickness Line thickness in pixels.
+         */
+        void contour(const cv::Mat& grid,
+            const std::vector<double>& levels,
+            double x0, double y0, double x1, double y1,
+            Colormap cmap = Colormap::Viridis,
+            float thickness = 1.f,
+            const std::string& label = "");
+
+        /**
+         * @brief Draw iso-lines of a 2-D grid with one data unit per cell.
+         *
+         * Same as the extent overload with [0, cols] x [0, rows].
+         */
+        void contour(const cv::Mat& grid,
+            const std::vector<double>& levels,
+            Colormap cmap = Colormap::Viridis,
+            float thickness = 1.f,
+            const std::string& label = "");
+
+        /**
+         * @brief Draw a histogram of raw samples.
+         *
+         * The samples are kept and binned at render time: over their finite
+         * range while the axes autoscale, over the visible x-range otherwise,
+         * so changing the x-limits re-bins the same samples without a copy.
+         * Binning runs in parallel into per-thread partial histograms and the
+         * counts are cached until the bin range changes. All bars are filled
+         * with one polygon call and outlined with another.
+         *
+         * @param data  Samples; NaN and infinities are ignored.
+         * @param bins  Number of equal-width bins (>= 1).
+         * @param style Bar fill and outline.
+         */
+        void hist(const std::vector<double>& data,
+            int bins = 10,
+            const ShapeStyle& style = ShapeStyle{ Color::Black(), 1.0f, Color::Blue(), 1.0f },
+            const std::string& label = "");
+
+        /// @brief Histogram overload that takes ownership of the samples.
+        void hist(std::vector<double>&& data,
+            int bins = 10,
+            const ShapeStyle& style = ShapeStyle{ Color::Black(), 1.0f, Color::Blue(), 1.0f },
+            const std::string& label = "");
+
+        /// @brief Histogram overload sharing an existing series (e.g. a mapped file).
+        void hist(const Series& data,
+            int bins = 10,
+            const ShapeStyle& style = ShapeStyle{ Color::Black(), 1.0f, Color::Blue(), 1.0f },
+            const std::string& label = "");
+
+        /**
+         * @brief Draw every row (or column) of a matrix as a polyline over a shared x.
+         *
+         * Rows are the series when Y.cols == x.size(), otherwise columns are
+         * (Y.rows == x.size()). The samples are copied once, channel-major,
+         * keeping 8-bit, float and double depths (others become float); x is
+         * kept once for all channels, bounds take one pass over x and one over
+         * the matrix, and each frame maps x to pixel columns once and reduces
+         * every channel to at most four points per column before drawing it
+         * with a single polyline call.
+         *
+         * @param x         Shared x-coordinates.
+         * @param Y         Single-channel matrix; mismatched shapes are ignored.
+         * @param cmap      Channel colors: Tab10 cycles, other maps spread the
+         *                  channels over the table.
+         * @param thickness Line thickness in pixels.
+         */
+        void plot_matrix(const std::vector<double>& x,
+            const cv::Mat& Y,
+            Colormap cmap = Colormap::Tab10,
+            float thickness = 1.f,
+            const std::string& label = "");
+
+        /// @brief Matrix overload sharing an existing x series with other commands.
+        void plot_matrix(const Series& x,
+            const cv::Mat& Y,
+            Colormap cmap = Colormap::Tab10,
+            float thickness = 1.f,
+            const std::string& label = "");
+
+        /**
+         * @brief Fill the band between two curves sampled at the same x.
+         *
+         * The outline is built in pixel space straight from the three arrays
+         * (upper curve forward, lower curve back) with the min/max column
+         * decimation lines use, and filled with a single polygon call, so
+         * multi-million-sample bands cost about one point per pixel column.
+         *
+         * @param x     X-coordinates.
+         * @param y_lo  Lower curve (must match size of @p x).
+         * @param y_hi  Upper curve (must match size of @p x).
+         * @param style Fill and outline; no outline by default.
+         */
+        void fill_between(const std::vector<double>& x,
+            const std::vector<double>& y_lo,
+            const std::vector<double>& y_hi,
+            const ShapeStyle& style = ShapeStyle{ Color::Blue(), 0.0f, Color::Blue(), 0.3f },
+            const std::string& label = "");
+
+        /// @brief Band overload sharing existing series (e.g. mapped files).
+        void fill_between(const Series& x,
+            const Series& y_lo,
+            const Series& y_hi,
+            const ShapeStyle& style = ShapeStyle{ Color::Blue(), 0.0f, Color::Blue(), 0.3f },
+            const std::string& label = "");
+
         /**
          * @brief Place a text annotation at data coordinates.
          *
@@ -391,6 +681,32 @@ namespace mpocv
         void legend(bool on = true, const std::string& loc = "northEast");
 
 
+        // ========================================================================
+        // Subplots
+        // ========================================================================
+
+        /**
+         * @brief Select (and create on first use) one cell of a rows x cols subplot grid.
+         *
+         * MATLAB-style subplot(m, n, p): the canvas is split into a grid of
+         * equally sized cells and the cell with 1-based, row-major index @p index
+         * is returned. Every cell is a Figure of its own, with its own command
+         * list, axes, ticks, labels and legend, whose canvas is a view (ROI) into
+         * this figure's canvas. Calling subplot() with a different grid shape
+         * discards the previous cells.
+         *
+         * Once a grid exists, this figure only draws its title (as a super-title
+         * above the grid); render() draws the dirty cells in parallel, one cell
+         * per worker, directly into the shared canvas.
+         *
+         * @param rows  Number of grid rows (clamped to >= 1).
+         * @param cols  Number of grid columns (clamped to >= 1).
+         * @param index 1-based cell index in row-major order (clamped to the grid).
+         * @return Figure& The cell; the reference stays valid until the grid shape changes.
+         */
+        Figure& subplot(int rows, int cols, int index);
+
+
         // ========================================================================
         // Core functions for rendering, showing, and saving the figure.
         // ========================================================================
@@ -400,27 +716,405 @@ namespace mpocv
          *
          * Renders the plot by converting retained drawing commands to pixels.
          * If the figure is already rendered (i.e., not dirty), the function returns immediately.
+         * A progressive render that is still in progress is finished without a time limit.
          */
         void render();
 
+        /**
+         * @brief Render incrementally within a time budget.
+         *
+         * The first call after a change draws a coarse pass in which line and
+         * scatter series are subsampled to a few hundred thousand points;
+         * later calls refine with half the stride per pass until every point
+         * is drawn. Each pass is drawn off-screen and replaces the canvas only
+         * when complete, so show() / save() in between display the latest
+         * complete approximation. Any change to the figure restarts the
+         * sequence. At least one chunk of work is done per call.
+         *
+         * @code
+         * RenderProgress p;
+         * do { p = fig.render_progressive(30.0); fig.show(); } while (!p.complete);
+         * @endcode
+         *
+         * Subplot grids are rendered in full (cells are already parallel).
+         *
+         * @param budget_ms Time allowed for this call in milliseconds.
+         * @return RenderProgress State after this call.
+         */
+        RenderProgress render_progressive(double budget_ms);
+
         /**
          * @brief Render (if needed) and display the figure in an OpenCV window.
          *
          * If the canvas is marked as dirty, render() is called before displaying.
+         * While a render_progressive() sequence is running, the latest complete
+         * pass is shown as is. With buffer_count() > 1 the rendered frame is
+         * swapped to the front first and the front buffer is displayed.
          *
          * @param window_name Name of the OpenCV window. Defaults to "Figure".
          */
         void show(const std::string& window_name = "Figure");
 
+        /**
+         * @brief Number of canvas buffers: 1 (default), 2 (double) or 3 (triple buffering).
+         *
+         * With more than one buffer, render() draws into a back buffer while
+         * the frame last published by swap_buffers() stays untouched, so frame
+         * N can be displayed, encoded or streamed from front() on one thread
+         * while frame N + 1 renders on another. With three buffers the
+         * previous front also survives one more swap, for consumers that
+         * finish a frame later than the next one is published.
+         *
+         * Call on the top-level figure, not on a subplot cell. The buffers are
+         * initialized with the current canvas.
+         *
+         * @param n Buffer count, clamped to [1, 3].
+         */
+        void buffer_count(int n);
+
+        /// @brief Current buffer count (see buffer_count(int)).
+        int buffer_count() const { return static_cast<int>(frames_.size()) + 1; }
+
+        /**
+         * @brief Publish the rendered canvas as the front frame and render into another buffer.
+         *
+         * The oldest published buffer becomes the new render target and is
+         * refreshed with the front frame unless a full redraw is pending, so
+         * partial updates (e.g. a single dirty subplot cell) stay correct.
+         * Subplot cells are re-pointed at their ROI of the new target.
+         * No-op with a single buffer.
+         *
+         * Must not overlap a render() of this figure; reads of earlier front()
+         * frames on other threads may continue.
+         *
+         * @code
+         * fig.buffer_count(2);
+         * std::thread worker;
+         * for (;;) {
+         *     if (worker.joinable()) worker.join();
+         *     fig.swap_buffers();
+         *     cv::Mat frame = fig.front();           // frame N
+         *     worker = std::thread([&] { update(fig); fig.render(); });   // frame N + 1
+         *     cv::imshow("live", frame); cv::waitKey(1);
+         * }
+         * @endcode
+         */
+        void swap_buffers();
+
+        /**
+         * @brief The frame published by the last swap_buffers() (the canvas itself with one buffer).
+         *
+         * The returned header shares the pixels; they are not written again
+         * until buffer_count() - 1 further swaps.
+         */
+        cv::Mat front() const { return frames_.empty() ? canvas_ : frames_.front(); }
+
+        /**
+         * @brief Show the figure in a window and explore it with the mouse until closed.
+         *
+         * - Mouse wheel: zoom about the cursor.
+         * - Left drag: pan.
+         * - Right click, double click or 'r': reset to the limits on entry.
+         * - Esc, 'q' or closing the window: return.
+         *
+         * In a subplot grid the cell under the cursor is zoomed or panned.
+         * While the view changes, frames are drawn with RenderQuality::Draft
+         * through render_progressive(), whose first pass subsamples and culls
+         * large series, so interaction stays responsive on very large figures.
+         * After a short idle period the view is refined at RenderQuality::Final.
+         * The render quality in effect on entry is restored on return; the
+         * limits stay where the user left them.
+         *
+         * @param window_name Name of the OpenCV window. Defaults to "Figure".
+         */
+        void interact(const std::string& window_name = "Figure");
+
+        /**
+         * @brief Find the plotted sample nearest to canvas pixel (px, py).
+         *
+         * Series points (line, scatter, polygon vertices, segment end points,
+         * line-matrix samples) are kept in a uniform grid built on the first
+         * call and extended with the commands appended since, so a pick visits
+         * only the cells within @p radius instead of every point. Other shapes
+         * are matched by their bounding box and only when no series point is
+         * in range; text is never picked. Memory-budget drops or decimation
+         * and replay() rebuild the index on the next call.
+         *
+         * Positions refer to the limits of the last render (or the pending
+         * autoscale when the figure is dirty). In a subplot grid the cell under
+         * the pixel is searched and reported in PickResult::subplot.
+         *
+         * @param px     Canvas x in pixels.
+         * @param py     Canvas y in pixels.
+         * @param radius Search radius in pixels.
+         * @return PickResult found == false if nothing is within @p radius.
+         */
+        PickResult pick(int px, int py, double radius = 5.0);
+
         /**
          * @brief Render (if needed) and save the figure to disk.
          *
          * Renders the canvas if needed and writes the image to disk.
          * The image format is inferred from the file extension.
          *
+         * A ".svg" extension writes vector output instead: the commands are
+         * streamed straight to the file without rasterizing. Line series with
+         * more points than a few per pixel column are reduced to the output
+         * resolution (min/max per column), so large figures export in bounded
+         * memory and produce compact files.
+         *
          * @param filename Output file path.
+         * @param params   Encoder settings for raster formats (see EncodeParams).
          */
-        void save(const std::string& filename);
+        void save(const std::string& filename, const EncodeParams& params = {});
+
+        /**
+         * @brief Render at full quality and encode the canvas into memory.
+         *
+         * The in-memory counterpart of save() for raster formats, for sending
+         * figures over IPC or HTTP without a round trip through the file
+         * system. @p out is cleared and refilled, so passing the same vector
+         * for every frame reuses its capacity and steady-state encodes do not
+         * allocate an output buffer. Encoding an unchanged figure again does
+         * not re-render it.
+         *
+         * @param format Encoder extension: "png", "jpg", "webp", ... (leading dot optional).
+         * @param out    Receives the encoded bytes; empty on failure.
+         * @param params Encoder settings (see EncodeParams).
+         * @return false if there is no encoder for @p format (or it is "svg").
+         */
+        bool encode(const std::string& format, std::vector<uint8_t>& out, const EncodeParams& params = {});
+
+        /// @brief encode() into a new vector (empty on failure).
+        std::vector<uint8_t> encode(const std::string& format, const EncodeParams& params = {});
+
+        /**
+         * @brief Serve rendered frames as MJPEG over HTTP (view at http://127.0.0.1:port/).
+         *
+         * For watching live figures in a browser on headless machines instead
+         * of cv::imshow(). After each render() (and each completed
+         * render_progressive() pass) the canvas is JPEG-encoded once and
+         * handed to all connected clients; see MjpegServer for the
+         * latest-frame-wins delivery, which keeps slow clients from ever
+         * blocking rendering. Nothing is encoded while no client is
+         * connected, and frames rendered faster than @p max_fps are skipped;
+         * the newest one goes out with a later render() call.
+         *
+         * Call on the top-level figure. A second call restarts the server.
+         *
+         * @param port         TCP port, 0 for any free one (see stream_port()).
+         * @param max_fps      Frame-rate cap of the stream.
+         * @param jpeg_quality JPEG quality 0 .. 100.
+         * @param bind_addr    IPv4 address to listen on; loopback by default.
+         * @return false if the port could not be bound.
+         */
+        bool stream_mjpeg(int port, double max_fps = 25.0, int jpeg_quality = 80,
+            const std::string& bind_addr = "127.0.0.1");
+
+        /// @brief Stop the MJPEG server and disconnect its clients.
+        void stop_stream();
+
+        /// @brief Port of the running MJPEG server, or 0.
+        int stream_port() const { return mjpeg_ && mjpeg_->running() ? mjpeg_->port() : 0; }
+
+        /**
+         * @brief Publish every rendered frame into a shared-memory ring.
+         *
+         * Creates the POSIX segment @p name (replacing a stale one) with
+         * @p slots frame slots sized for the current canvas in the widest
+         * canvas_format() (BGR16), so switching formats later keeps publishing;
+         * render() then copies each new frame into the next slot. No encoding,
+         * no locks and no waiting on the reader: a viewer process
+         * (tools/mpocv_view) maps the ring and shows frames at its own pace,
+         * keeping highgui out of this process. A frame that still does not fit
+         * re-creates the ring under the same name; the viewer re-attaches.
+         *
+         * Call on the top-level figure. Not available on Windows.
+         *
+         * @param name  Segment name, e.g. "mpocv" (appears as /dev/shm/mpocv on Linux).
+         * @param slots Frame slots; more slots give a slow reader longer to copy a frame.
+         * @return false if the segment could not be created.
+         */
+        bool publish_shm(const std::string& name, int slots = 3);
+
+        /// @brief Stop publishing and unlink the shared-memory segment.
+        void stop_shm();
+
+
+        // ========================================================================
+        // Concurrent producers
+        // ========================================================================
+
+        /**
+         * @brief Queue through which other threads add samples and commands.
+         *
+         * Created on the first call with the given capacities (later calls
+         * return the same feed). Call it, and add_stream(), on the thread that
+         * owns the figure before starting producers; afterwards producers only
+         * touch the returned FigureFeed. Queued data is applied on the owner
+         * thread at the start of render(), render_progressive() and each
+         * interact() frame; a subplot cell has its own feed and is drained
+         * with its parent.
+         *
+         * The feed is shared so that producers may keep pushing safely after
+         * the figure is gone; their samples are then simply never drained.
+         *
+         * @param sample_capacity  Samples buffered between frames (rounded up to a power of two).
+         * @param command_capacity Commands buffered between frames (rounded up to a power of two).
+         */
+        std::shared_ptr<FigureFeed> feed(size_t sample_capacity = 65536, size_t command_capacity = 1024);
+
+        /**
+         * @brief Declare a line that producers extend with FigureFeed::push().
+         *
+         * Drained samples are appended in place to the stream's open line
+         * command. When its buffers are full a new line starts from the last
+         * sample, with twice the capacity (up to 65536 points), so a stream
+         * holds a handful of commands and a memory_budget() with
+         * MemoryPolicy::DropOldest still turns it into a rolling window.
+         *
+         * @return Stream id to pass to FigureFeed::push().
+         */
+        int add_stream(Color color = Color::Blue(), float thickness = 1.0f, const std::string& label = "");
+
+        // ========================================================================
+        // Record / replay
+        // ========================================================================
+
+        /**
+         * @brief Write the command stream, axes settings and subplot grid to a binary file.
+         *
+         * Series arrays are stored raw and 64-byte aligned so that replay() can
+         * map the file instead of parsing it. The format uses native byte order
+         * and is meant for the machine (or architecture) that wrote it. Bounds of
+         * mapped series that have not been rendered yet are resolved first.
+         *
+         * @param filename Output file path.
+         * @return true on success.
+         */
+        bool record(const std::string& filename);
+
+        /**
+         * @brief Replace this figure's content with a recording made by record().
+         *
+         * The file is memory-mapped and the series of the replayed commands
+         * point straight into the mapping, which stays open as long as any of
+         * them is alive. Canvas size and memory settings are kept. On a
+         * malformed or truncated file nothing is changed.
+         *
+         * @param filename Recording to load.
+         * @return true on success.
+         */
+        bool replay(const std::string& filename);
+
+
+        /**
+         * @brief Select how render() trades speed against anti-aliasing.
+         *
+         * Each primitive type gets the cheapest rasterization that meets the
+         * chosen quality (see RenderQuality). save() and encode() render
+         * raster output at Final (unless EncodeParams::final_quality is false)
+         * and restore this setting afterwards without redrawing; a canvas that
+         * is already up to date at Final is encoded as is. The setting is
+         * forwarded to subplot cells.
+         *
+         * @param q Quality level. Defaults to Normal.
+         */
+        void render_quality(RenderQuality q);
+
+        /// @brief Current render quality.
+        RenderQuality render_quality() const { return quality_; }
+
+        /**
+         * @brief Select the canvas pixel format.
+         *
+         * Reallocates the canvas (and any buffers of buffer_count()) in the
+         * new format and marks the figure dirty. All drawing, translucent
+         * blending, colormapped images and labels then work natively in that
+         * format, so GRAY8 touches a third of the bytes of BGR8 per fill and
+         * BGRA8 keeps real coverage in the alpha channel instead of blending
+         * against white. save() writes the canvas as is (16-bit PNG / TIFF;
+         * other file types get BGR16 scaled down to 8 bits), except that BGRA8
+         * is stored with straight alpha (PNG / TIFF / WebP) or flattened onto
+         * white (JPEG and the MJPEG stream). The setting is
+         * forwarded to subplot cells; set it on the top-level figure.
+         *
+         * @param f Pixel format. Defaults to CanvasFormat::BGR8.
+         */
+        void canvas_format(CanvasFormat f);
+
+        /// @brief Current canvas pixel format.
+        CanvasFormat canvas_format() const { return format_; }
+
+
+        // ========================================================================
+        // Instrumentation
+        // ========================================================================
+
+        /**
+         * @brief Enable or disable per-stage render timing and counters.
+         *
+         * When enabled, every render() that actually redraws resets and fills
+         * the RenderStats returned by render_stats(). When disabled the timers
+         * are skipped entirely; only a few integer counters are still bumped.
+         * The setting is forwarded to existing subplot cells.
+         *
+         * @param on Flag to enable (true) or disable (false) collection.
+         */
+        void collect_stats(bool on = true);
+
+        /**
+         * @brief Timings and counters of the most recent render().
+         *
+         * @return const RenderStats& Valid only while collect_stats() is on.
+         */
+        const RenderStats& render_stats() const { return stats_; }
+
+        /**
+         * @brief Report the bytes retained by this figure.
+         *
+         * Lists command memory per CmdType and per series, the canvas and the
+         * render caches. For a figure split into subplots the cells' commands
+         * and caches are included (their canvases are views of this one).
+         *
+         * @return MemoryUsage Snapshot of the current retention.
+         */
+        MemoryUsage memory_usage() const;
+
+        /**
+         * @brief Cap the memory retained by commands.
+         *
+         * Whenever adding a command would push the retained command bytes
+         * (MemoryUsage::commands()) above @p bytes, @p policy is applied first:
+         * DecimateOldest thins the oldest series (falling back to dropping
+         * commands once nothing is left to thin; views of mapped files are
+         * dropped, never copied into memory), DropOldest removes commands
+         * from the front, and Throw rejects the new command with
+         * std::length_error, leaving the figure unchanged. The newest command
+         * is always kept by the first two policies, even if it alone exceeds
+         * the budget. The first two policies also trim the existing commands
+         * right away. The setting is forwarded to existing subplot cells (each
+         * cell has its own budget).
+         *
+         * @param bytes  Budget in bytes; 0 disables the limit.
+         * @param policy What to do when the budget would be exceeded.
+         */
+        void memory_budget(size_t bytes, MemoryPolicy policy = MemoryPolicy::DropOldest);
+
+
+        // ========================================================================
+        // Utilities
+        // ========================================================================
+
+        /**
+         * @brief Generate "nice" tick positions and formatted labels for a range.
+         *
+         * @param lo     Lower end of the axis range (data units).
+         * @param hi     Upper end of the axis range (data units).
+         * @param target Approximate number of ticks wanted.
+         * @return TickInfo Tick locations inside [lo, hi] and their labels.
+         */
+        static TickInfo make_ticks(double lo, double hi, int target = 6);
 
 
     private:
@@ -432,11 +1126,15 @@ namespace mpocv
         static constexpr int kMarginBottom = 60;///< Bottom margin in pixels.
         static constexpr int kTickLen = 5;      ///< Length of tick marks in pixels.
         static constexpr int kMargin = 50;      ///< Margin for the title.
+        static constexpr size_t kCoarsePoints = size_t(1) << 18;  ///< Work of the first progressive pass.
+        static constexpr size_t kProgressChunk = size_t(1) << 14; ///< Samples drawn between deadline checks.
 
         // Canvas and retained state
+        std::pmr::memory_resource* mr_;             ///< Allocation source for commands and their payloads.
         int                       width_, height_;  ///< Canvas dimensions in pixels.
         cv::Mat                   canvas_;          ///< OpenCV image matrix representing the canvas.
-        std::vector<PlotCommand>  cmds_;            ///< Retained plot commands.
+        std::vector<cv::Mat>      frames_;          ///< Published buffers, newest (front()) first; empty when single-buffered.
+        std::pmr::vector<PlotCommand> cmds_;        ///< Retained plot commands.
         Axes                      axes_;            ///< Axes representing the data coordinate system.
         std::string               title_, xlabel_, ylabel_; ///< Title and axis labels.
         bool                      dirty_{ true };   ///< Flag indicating if the canvas needs re-rendering.
@@ -447,11 +1145,161 @@ namespace mpocv
 
         // Cached data bounds for fast autoscale
         Bounds                    data_bounds_;     ///< Cached bounds of the plotted data.
+        static constexpr size_t   kNoPendingBounds = static_cast<size_t>(-1);
+        size_t                    bounds_pending_from_{ kNoPendingBounds }; ///< First command not yet in data_bounds_ (mapped series; 0 once a budget trim cleared it).
+
+        // Reused conversion buffer for OpenCV text calls (avoids a per-draw allocation)
+        std::string               text_scratch_;
 
         // Cached rotated y‑label
         cv::Mat                   ylabel_cache_;    ///< Cached rotated image for the y-axis label.
         bool                      ylabel_cache_valid_{ false }; ///< Flag indicating if the y-label cache is valid.
 
+        // Progressive rendering (see render_progressive())
+        struct ProgressState
+        {
+            bool           active{ false };   ///< A pass sequence is in progress.
+            cv::Mat        back;              ///< Off-screen target of the pass in progress.
+            TickInfo       xt, yt;            ///< Ticks fixed for the whole sequence.
+            size_t         cmd{ 0 };          ///< Next command of the current pass.
+            size_t         pos{ 0 };          ///< Next sample within that command.
+            RenderProgress info;              ///< Reported state.
+        };
+        ProgressState             prog_;
+
+        /// Owning handle to an endpoint bound to one figure (see Figure(const Figure&)):
+        /// a copy starts empty and copy assignment keeps the target's own.
+        template<typename Ptr>
+        struct PerInstance : Ptr
+        {
+            using Ptr::Ptr;
+            using Ptr::operator=;
+            PerInstance() = default;
+            PerInstance(const PerInstance&) noexcept : Ptr() {}
+            PerInstance(PerInstance&&) = default;
+            PerInstance& operator=(const PerInstance&) noexcept { return *this; }
+            PerInstance& operator=(PerInstance&&) = default;
+        };
+
+        // MJPEG streaming (see stream_mjpeg())
+        PerInstance<std::unique_ptr<MjpegServer>> mjpeg_;
+        double                    mjpeg_interval_s_{ 0.04 };  ///< 1 / max_fps.
+        int                       mjpeg_quality_{ 80 };
+        int64_t                   mjpeg_last_ns_{ 0 };        ///< steady_clock time of the last published frame.
+        uint64_t                  mjpeg_sent_seq_{ 0 };       ///< frame_seq_ of the last published frame.
+        uint64_t                  frame_seq_{ 0 };            ///< Incremented whenever a complete frame lands on canvas_.
+
+        // Shared-memory publishing (see publish_shm())
+        PerInstance<std::unique_ptr<ShmPublisher>> shm_;
+        uint64_t                  shm_sent_seq_{ 0 };         ///< frame_seq_ of the last frame written to the ring.
+        std::string               shm_name_;                  ///< Segment name given to publish_shm().
+        int                       shm_slots_{ 3 };            ///< Slot count given to publish_shm().
+
+        // Reused 8-bit copy of a BGR16 canvas for encoders without 16-bit support
+        cv::Mat                   encode_scratch_;
+
+        // Reused target for translucent fills (only the shape's bounding box is touched)
+        cv::Mat                   blend_scratch_;
+
+        // Reused outline buffers for fill_between commands
+        std::vector<PixelPoint>   band_scratch_;
+        std::vector<cv::Point>    band_px_;
+
+        // Reused buffers for line matrices: pixel column of each shared x, one channel's polyline
+        std::vector<int>          matrix_px_;
+        std::vector<cv::Point>    matrix_pts_;
+
+        // Colorized image commands, valid while the axes and canvas size are unchanged
+        struct ImageCacheEntry
+        {
+            uint64_t    id{ 0 };                  ///< ImageData::id of the command.
+            Axes        axes;                     ///< Limits the pixels were made for.
+            int         width{ 0 }, height{ 0 };  ///< Canvas size they were made for.
+            ImageInterp interp{ ImageInterp::Nearest }; ///< Effective sampling.
+            cv::Rect    dst;                      ///< Canvas region covered.
+            cv::Mat     bgr;                      ///< Pixels for dst, in the canvas format.
+        };
+        std::vector<ImageCacheEntry> image_cache_;
+
+        // Binned histogram commands, valid while the bin range is unchanged
+        struct HistCacheEntry
+        {
+            uint64_t    id{ 0 };                  ///< HistData::id of the command.
+            bool        have_range{ false };      ///< dmin / dmax are set.
+            double      dmin{ 0 }, dmax{ 0 };     ///< Finite range of the samples.
+            double      lo{ 0 }, hi{ 0 };         ///< Range the counts were binned over.
+            std::vector<uint64_t> counts;         ///< One count per bin (empty = not binned yet).
+        };
+        std::vector<HistCacheEntry> hist_cache_;
+
+        // Hit-test index (see pick()): series points in a grid, other shapes by bounding box
+        struct PickShape
+        {
+            size_t cmd{ 0 };                      ///< Command index + pick_dropped_ when indexed.
+            Bounds box;                           ///< Data-space bounding box.
+        };
+        SpatialGrid               pick_grid_;
+        std::vector<PickShape>    pick_shapes_;
+        size_t                    pick_indexed_{ 0 };  ///< Commands [0, pick_indexed_) are indexed.
+        size_t                    pick_sized_for_{ 0 }; ///< Point count the grid cells were laid out for.
+        size_t                    pick_dropped_{ 0 };   ///< Commands dropped from the front since the grid was laid out.
+
+        // Producer queues (see feed()) and the streams their samples extend
+        struct FeedStream
+        {
+            Color       color;
+            float       thickness{ 1.0f };
+            std::string label;                    ///< Given to the first line only (one legend entry).
+            bool        labeled{ false };
+            std::shared_ptr<std::pmr::vector<double>> bx, by;   ///< Open line's buffers; its Series view their filled part.
+            size_t      line{ 0 };                ///< Index of the open line in cmds_ while it still views bx / by.
+            std::vector<double> xs, ys;           ///< Samples drained this frame.
+        };
+        PerInstance<std::shared_ptr<FigureFeed>> feed_;
+        std::vector<FeedStream>   streams_;
+
+        // Memory accounting
+        size_t                    cmd_bytes_{ 0 };  ///< Retained command bytes (see memory_usage()).
+        size_t                    mem_budget_{ 0 }; ///< Command byte budget, 0 = unlimited.
+        MemoryPolicy              mem_policy_{ MemoryPolicy::DropOldest }; ///< Applied when over budget.
+
+        // Instrumentation
+        RenderStats               stats_;           ///< Filled by render() when stats_on_.
+        bool                      stats_on_{ false }; ///< Collect timings in render().
+        RenderQuality             quality_{ RenderQuality::Normal }; ///< Line types used by render().
+        RenderQuality             drawn_quality_{ RenderQuality::Normal }; ///< Quality the canvas was last drawn at.
+        CanvasFormat              format_{ CanvasFormat::BGR8 };     ///< Pixel format of canvas_ (see canvas_format()).
+
+        /// @brief Stage timing slot, or nullptr while collection is off.
+        double* stage_slot(RenderStage s) { return stats_on_ ? &stats_.stage_ns[static_cast<size_t>(s)] : nullptr; }
+
+        // Subplot grid (cells render into ROIs of canvas_)
+        std::vector<Figure>       subplots_;        ///< Grid cells in row-major order; empty when not split.
+        int                       sub_rows_{ 0 }, sub_cols_{ 0 }; ///< Grid shape.
+
+        /**
+         * @brief Construct a subplot cell that draws into a view of a parent canvas.
+         *
+         * @param roi Header referencing the cell's region of the parent canvas.
+         * @param mr  Memory resource shared with the parent.
+         */
+        Figure(const cv::Mat& roi, std::pmr::memory_resource* mr);
+
+        /// @brief Adopts @p f here and in every cell: drops format-dependent caches and marks dirty.
+        void apply_format(CanvasFormat f);
+
+        /// @brief Makes @p target the canvas and re-points every subplot cell at its ROI of it.
+        void rebind_canvas(const cv::Mat& target);
+
+        /// @brief Assigns each subplot cell its ROI of the canvas (below the title band).
+        void layout_subplots();
+
+        /// @brief Region of subplot cell @p i within this figure's canvas.
+        cv::Rect subplot_rect(int i) const;
+
+        /// @brief Renders the super-title and all dirty subplot cells in parallel.
+        void render_subplots();
+
         /// @brief Returns the width of the plot area.
         int  plot_width()  const { return width_ - kMarginLeft - kMarginRight; }
 
@@ -470,50 +1318,257 @@ namespace mpocv
         cv::Point2i data_to_pixel(double x, double y) const;
 
         /**
-         * @brief Convert a custom Color to OpenCV cv::Scalar with optional alpha.
+         * @brief Convert a custom Color to the cv::Scalar drawn into this canvas.
          *
-         * Converts an mpocv::Color to a cv::Scalar in BGR(A) format. The alpha
-         * channel is returned as a scaled 0–255 uchar if specified, but is only
-         * meaningful when drawing into a 4-channel (CV_8UC4) canvas.
+         * BGR for BGR8, luma for GRAY8, BGR plus alpha for BGRA8 and BGR
+         * scaled to 16 bits for BGR16 (see CanvasFormat). Every color passed
+         * to an OpenCV drawing call goes through here.
          *
          * @param c The Color to convert (RGB format).
-         * @param alpha Alpha multiplier in range [0.0, 1.0]. Default is 1.0 (opaque).
-         * @return cv::Scalar The OpenCV-compatible color (B, G, R, A).
+         * @param alpha Alpha in range [0.0, 1.0], used by BGRA8 only. Default is 1.0 (opaque).
+         * @return cv::Scalar The color in the canvas format.
+         */
+        cv::Scalar cv_color(const Color& c, float alpha = 1.0f) const;
+
+        /// @brief Canvas fill before drawing: white, or transparent for BGRA8.
+        cv::Scalar background() const;
+
+        /**
+         * @brief Scratch image for a translucent shape, with @p roi copied from the canvas.
+         *
+         * Only @p roi is valid afterwards; draw the shape into it and pass
+         * the same region to blend_shape().
+         *
+         * @param roi Shape bounding box, already clipped to the canvas.
          */
-        cv::Scalar cv_color(const Color& c, float alpha = 1.0f);
+        cv::Mat& blend_scratch(const cv::Rect& roi);
 
         /**
-         * @brief Blend a shape drawn into a temporary buffer onto the main canvas using alpha.
+         * @brief Blend a shape drawn into a scratch region onto the same region of the canvas.
          *
-         * @param shape Image containing the shape (same size as canvas_).
+         * @param shape Region of the scratch image containing the shape.
+         * @param roi   Matching region of canvas_.
          * @param alpha Blend factor in range [0.0, 1.0].
          */
-        void blend_shape(const cv::Mat& shape, float alpha);
+        void blend_shape(const cv::Mat& shape, const cv::Rect& roi, float alpha);
 
 
         /* ---------- axis, grid, tick helpers ------------------------------ */
         /// @brief Computes a "nice" number for tick spacing.
         static double nice_num(double range, bool round);
 
-        /// @brief Generates tick positions and formatted labels.
-        static TickInfo make_ticks(double lo, double hi, int target = 6);
-
         /// @brief Draws the axis lines, ticks, and numeric labels.
         void draw_axes(const TickInfo& xt, const TickInfo& yt);
 
         /// @brief Draws grid lines corresponding to tick positions.
         void draw_grid(const TickInfo& xt, const TickInfo& yt);
 
-        /// @brief Expands the cached data bounds using the given vectors.
-        void expand_bounds(const std::vector<double>& xs, const std::vector<double>& ys);
+        /* ---------- render stages ----------------------------------------- */
+        /// @brief Computes axes_ limits (autoscale, padding, equal-scale).
+        void update_limits();
+
+        /// @brief Rasterizes a single retained command onto the canvas.
+        void draw_command(const PlotCommand& cmd);
+
+        /// @brief Draws the legend box when enabled.
+        void draw_legend();
+
+        /// @brief Draws the title, x-label and rotated y-label.
+        void draw_labels();
+
+        /// @brief Expands the cached data bounds using the given series.
+        void expand_bounds(const Series& xs, const Series& ys);
+
+        /// @brief Expands the cached data bounds by the extent of one command.
+        void expand_bounds(const PlotCommand& cmd);
+
+        /// @brief Scans commands added since bounds_pending_from_ (views of mapped files).
+        void resolve_pending_bounds();
+
+        /* ---------- command list / memory helpers ------------------------- */
+        /// @brief Appends a command: applies the memory budget, updates bounds and marks dirty.
+        void push_command(PlotCommand&& cmd);
+
+        /// @brief Appends a command whose extent is already in data_bounds_ (no budget, no bounds pass).
+        void adopt_command(PlotCommand&& cmd);
+
+        /* ---------- recording helpers (src/recording.cpp) ----------------- */
+        /// @brief Writes settings, commands and subplot cells of this figure.
+        void write_section(RecordWriter& out);
+
+        /// @brief Reads a section written by write_section() into this (fresh) figure.
+        bool read_section(RecordReader& in);
+
+        /// @brief Applies mem_policy_ so that @p incoming more bytes fit in the budget.
+        void enforce_budget(size_t incoming);
+
+        /// @brief Adds this figure's commands and caches to @p mu.
+        void add_memory_usage(MemoryUsage& mu, int subplot) const;
+
+        /* ---------- legend layout (shared by raster and SVG output) --------- */
+        struct LegendLayout
+        {
+            std::vector<const PlotCommand*> items;  ///< Labelled commands, in draw order.
+            cv::Point anchor;                       ///< Top-left corner of the box.
+            int swatch{ 20 };                       ///< Swatch width.
+            int line_h{ 0 };                        ///< Height of one entry.
+            int box_w{ 0 }, box_h{ 0 };             ///< Box size.
+        };
+
+        /**
+         * @brief Draws samples begin, begin+stride, ... of a Line or Scatter command.
+         *
+         * @param max_items Maximum number of segments / markers to draw.
+         * @return size_t Sample index to resume from, or the series size when done.
+         */
+        size_t draw_series_chunk(const PlotCommand& cmd, size_t begin, size_t stride, size_t max_items);
+
+        /**
+         * @brief Resamples and colorizes the visible part of an image command.
+         *
+         * @param d      Image command.
+         * @param interp Sampling to use.
+         * @param dst    Receives the canvas region covered (clipped to the plot area).
+         * @param bgr    Receives the pixels for @p dst.
+         * @return false if nothing is visible.
+         */
+        bool colorize_image(const ImageData& d, ImageInterp interp, cv::Rect& dst, cv::Mat& bgr) const;
+
+        /// @brief Draws an image command, reusing the cached pixels when the axes are unchanged.
+        void draw_image(const ImageData& d);
+
+        /// @brief Cache entry of histogram @p id, created (and stale entries dropped) on first use.
+        HistCacheEntry& hist_entry(uint64_t id);
+
+        /**
+         * @brief Finite range of a histogram command's samples, found once and cached.
+         *
+         * A flat range is widened by 0.5 on each side.
+         *
+         * @return false if the samples have no finite value.
+         */
+        bool hist_range(const HistData& d, double& lo, double& hi);
+
+        /// @brief Counts of a histogram command over [lo, hi], binned on first use and cached.
+        const std::vector<uint64_t>& hist_counts(const HistData& d, double lo, double hi);
+
+        /**
+         * @brief Bins of a histogram command for the current axes.
+         *
+         * @param lo Receives the left edge of the first bin.
+         * @param hi Receives the right edge of the last bin.
+         * @return Cached counts, or nullptr if there is nothing to draw.
+         */
+        const std::vector<uint64_t>* hist_bins(const HistData& d, double& lo, double& hi);
+
+        /// @brief Draws a histogram command as one batched fill plus one batched outline.
+        void draw_hist(const HistData& d);
+
+        /// @brief Draws a fill_between command from its decimated pixel outline.
+        void draw_band(const FillBetweenData& d);
+
+        /// @brief Draws all channels of a line matrix, mapping the shared x once.
+        void draw_line_matrix(const LineMatrixData& d);
+
+        /* ---------- interactive viewer helpers (src/interactive.cpp) ------ */
+        /**
+         * @brief Figure (this or a subplot cell) drawn at canvas point @p p.
+         *
+         * @param p Canvas point; rewritten to the returned figure's own pixels.
+         */
+        Figure& figure_at(cv::Point& p);
+
+        /// @brief Zooms by @p factor (< 1 zooms in) about pixel @p p.
+        void zoom_about(const cv::Point& p, double factor);
+
+        /// @brief Sets the limits to @p from shifted by a drag of (@p dx, @p dy) pixels.
+        void pan_from(const Axes& from, int dx, int dy);
+
+        /// @brief True if render() or render_progressive() has work left (here or in a cell).
+        bool needs_render() const;
+
+        /* ---------- hit-testing helpers (src/pick.cpp) -------------------- */
+        /// @brief Applies queued feed samples and commands here and in every subplot cell.
+        void drain_feeds();
+
+        /// @brief Indexes commands appended since the last pick(), rebuilding the grid when it is outgrown.
+        void update_pick_index();
+
+        /// @brief Forgets the hit-test index (commands were removed or changed).
+        void reset_pick_index();
+
+        /// @brief Unindexes the first @p n commands, which the caller has just erased.
+        void drop_from_pick_index(size_t n);
+
+        /// @brief Indexes points [from, end) appended in place to command @p cmd.
+        void index_appended_points(size_t cmd, size_t from);
+
+        /// @brief Data-space bounding box of one command.
+        Bounds command_box(const PlotCommand& cmd);
+
+        /// @brief Process-wide unique key for a new command's render cache entry.
+        static uint64_t new_cache_id();
+
+        /// @brief Work units (sampled points, or 1 per other command) of one pass at @p stride.
+        size_t pass_work(size_t stride) const;
+
+        /// @brief Clears canvas_ and draws grid and axes for a new pass.
+        void begin_pass();
+
+        /// @brief The render pipeline behind render(), without publishing.
+        void render_canvas();
+
+        /// @brief Hands a new frame to the shared-memory ring and the MJPEG server.
+        void publish_frame();
+
+        /// @brief Copies the canvas into the shared-memory ring if it holds a new frame.
+        void publish_shm_frame();
+
+        /// @brief Hands the canvas to the MJPEG server if a client waits and the frame-rate cap allows.
+        void publish_mjpeg();
+
+        /// @brief render() for save() / encode(): at Final unless the canvas already is, keeping quality_.
+        void render_for_encode(bool final_quality);
+
+        /// @brief True if the canvas (and every cell) is up to date and was drawn at @p q.
+        bool drawn_at(RenderQuality q) const;
+
+        /// @brief Sets quality_ here and in every cell without marking anything dirty.
+        void restore_quality(RenderQuality q);
+
+        /// @brief Canvas ready for the encoder of @p ext (BGR16 scaled to 8 bits where needed,
+        /// BGRA8 un-premultiplied, or flattened onto white for formats without alpha).
+        const cv::Mat& encodable(const std::string& ext);
+
+        /// @brief Computes the legend box; false if there is nothing to show.
+        bool legend_layout(LegendLayout& lay);
+
+        /* ---------- SVG output (src/svg_export.cpp) ----------------------- */
+        /// @brief Streams this figure as SVG to @p filename.
+        void save_svg(const std::string& filename);
+
+        /// @brief Writes this figure (and its subplot cells) at offset (@p ox, @p oy).
+        void write_svg(SvgWriter& out, int ox, int oy);
 
         /* ---------- rotated y-label helper -------------------------------- */
         /// @brief Draws and caches the rotated y-axis label.
         void draw_ylabel();
 
         /* ---------- text alignment helper --------------------------------- */
-        /// @brief Computes the anchored text position based on alignment.
-        cv::Point2i anchored_text_pos(const TextData& td) const;
+        /// @brief Computes the anchored text position of @p text based on alignment.
+        cv::Point2i anchored_text_pos(const TextData& td, const std::string& text) const;
+
+        /// @brief Copies @p s into text_scratch_ for OpenCV calls taking std::string.
+        const std::string& scratch_text(const std::pmr::string& s)
+        {
+            text_scratch_.assign(s.data(), s.size());
+            return text_scratch_;
+        }
+
+        /// @brief Wraps caller data as a Series: moved vectors are adopted, others copied into mr_.
+        Series make_series(std::vector<double>&& v) const { return Series(std::move(v)); }
+        Series make_series(const std::vector<double>& v) const { return Series(v, mr_); }
+        Series make_series(const Series& v) const { return v; }
 
         /* ---------- safety helpers ---------------------------------------- */
         /// @brief Ensures that the span between lo and hi is non-zero.
@@ -547,18 +1602,19 @@ namespace mpocv
         template<typename VX, typename VY>
         void add_line_command(VX&& x, VY&& y, Color c, float thickness, const std::string& label = "")
         {
-            PlotCommand cmd;
-            cmd.type = CmdType::Line;
+            PlotCommand cmd(CmdType::Line, mr_);
             cmd.color = c;
             cmd.label = label;
-            cmd.line.x = std::forward<VX>(x);
-            cmd.line.y = std::forward<VY>(y);
-            cmd.line.thickness = thickness;
-            expand_bounds(cmd.line.x, cmd.line.y);
-            cmds_.push_back(std::move(cmd));
-            dirty_ = true;
+            cmd.line().x = make_series(std::forward<VX>(x));
+            cmd.line().y = make_series(std::forward<VY>(y));
+            cmd.line().thickness = thickness;
+            push_command(std::move(cmd));
         }
 
+        /// @brief Adds a scatter command with per-point colormap indices (and optional sizes).
+        void add_scatter_indexed(const std::vector<double>& x, const std::vector<double>& y,
+            Series&& index, const std::vector<double>& sizes, Colormap cmap, const std::string& label);
+
         /**
          * @brief Adds a scatter drawing command.
          *
@@ -574,16 +1630,13 @@ namespace mpocv
         template<typename VX, typename VY>
         void add_scatter_command(VX&& x, VY&& y, Color c, float marker_size, const std::string& label)
         {
-            PlotCommand cmd;
-            cmd.type = CmdType::Scatter;
+            PlotCommand cmd(CmdType::Scatter, mr_);
             cmd.color = c;
             cmd.label = label;
-            cmd.scatter.x = std::forward<VX>(x);
-            cmd.scatter.y = std::forward<VY>(y);
-            cmd.scatter.marker_size = marker_size;
-            expand_bounds(cmd.scatter.x, cmd.scatter.y);
-            cmds_.push_back(std::move(cmd));
-            dirty_ = true;
+            cmd.scatter().x = make_series(std::forward<VX>(x));
+            cmd.scatter().y = make_series(std::forward<VY>(y));
+            cmd.scatter().marker_size = marker_size;
+            push_command(std::move(cmd));
         }
 
     }; // class Figure 
@@ -0,0 +1,86 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "mpsc_queue.h"
+
+namespace mpocv
+{
+    class Figure;
+
+    /**
+     * @class FigureFeed
+     * @brief Lock-free submission of samples and commands to a Figure from other threads.
+     *
+     * Obtained from Figure::feed(). Any number of producer threads may call
+     * push() and submit() concurrently while the thread that owns the Figure
+     * renders; nothing on this path takes a mutex. The owner drains both
+     * queues at the start of each frame (render(), render_progressive(),
+     * interact()), appending samples to their streams and running submitted
+     * commands against the figure, on its own thread.
+     *
+     * Both queues are bounded. When a producer outruns the renderer the push
+     * fails and is counted (dropped_samples(), dropped_commands()) rather than
+     * blocking the producer or growing memory.
+     */
+    class FigureFeed
+    {
+    public:
+        /// A command run on the rendering thread, e.g. [](Figure& f) { f.text(...); }.
+        using Command = std::function<void(Figure&)>;
+
+        /**
+         * @param sample_capacity  Samples buffered between two frames.
+         * @param command_capacity Commands buffered between two frames.
+         */
+        FigureFeed(size_t sample_capacity, size_t command_capacity)
+            : samples_(sample_capacity), commands_(command_capacity) {}
+
+        /**
+         * @brief Append sample (x, y) to a stream created with Figure::add_stream().
+         * @return false if the sample queue was full and the sample was dropped.
+         */
+        bool push(int stream, double x, double y)
+        {
+            return samples_.try_push(Sample{ stream, x, y });
+        }
+
+        /**
+         * @brief Run @p cmd on the rendering thread at the next frame.
+         *
+         * Constructing the std::function may allocate on the calling thread
+         * for large captures; the queue itself does not.
+         *
+         * @return false if the command queue was full and @p cmd was dropped.
+         */
+        bool submit(Command cmd)
+        {
+            return commands_.try_push(std::move(cmd));
+        }
+
+        uint64_t dropped_samples() const { return samples_.dropped(); }    ///< Samples lost to a full queue.
+        uint64_t dropped_commands() const { return commands_.dropped(); }  ///< Commands lost to a full queue.
+
+    private:
+        friend class Figure;
+
+        struct Sample
+        {
+            int    stream{ -1 };
+            double x{ 0 }, y{ 0 };
+        };
+
+        MpscQueue<Sample>  samples_;
+        MpscQueue<Command> commands_;
+    };
+
+} // namespace mpocv
@@ -0,0 +1,47 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "series.h"
+
+namespace mpocv
+{
+
+    /**
+     * @brief Minimum and maximum of the finite samples of @p s.
+     *
+     * Runs over chunks of the series with cv::parallel_for_.
+     *
+     * @param s  Samples (any SampleType or stride).
+     * @param lo Receives the minimum.
+     * @param hi Receives the maximum.
+     * @return false if @p s has no finite sample.
+     */
+    bool finite_min_max(const Series& s, double& lo, double& hi);
+
+    /**
+     * @brief Count the samples of @p s in @p bins equal-width bins over [lo, hi].
+     *
+     * Chunks of the series are binned in parallel, each into a partial
+     * histogram of its own, and the partials are summed afterwards, so no
+     * counter is shared between threads. Samples outside [lo, hi] and NaN
+     * are not counted; hi itself falls into the last bin.
+     *
+     * @param s      Samples (any SampleType or stride).
+     * @param lo     Left edge of the first bin.
+     * @param hi     Right edge of the last bin (must be > @p lo).
+     * @param bins   Number of bins (>= 1).
+     * @param counts Receives @p bins counts.
+     */
+    void histogram_counts(const Series& s, double lo, double hi, size_t bins, std::vector<uint64_t>& counts);
+
+} // namespace mpocv
@@ -0,0 +1,56 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace mpocv
+{
+
+    /**
+     * @class MappedFile
+     * @brief Read-only memory mapping of a whole file.
+     *
+     * Pages are loaded by the OS on first access, so mapping a large file is
+     * cheap until its contents are actually read. Series views into the
+     * mapping hold a shared_ptr to it, which keeps the mapping alive.
+     */
+    class MappedFile
+    {
+    public:
+        /**
+         * @brief Map @p filename read-only.
+         *
+         * @param filename Path of an existing, non-empty file.
+         * @return std::shared_ptr<const MappedFile> The mapping, or nullptr on failure.
+         */
+        static std::shared_ptr<const MappedFile> open(const std::string& filename);
+
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /// @brief First byte of the mapping (page aligned).
+        const unsigned char* data() const { return static_cast<const unsigned char*>(addr_); }
+
+        /// @brief Length of the mapping in bytes.
+        size_t size() const { return size_; }
+
+    private:
+        MappedFile() = default;
+
+        void*  addr_{ nullptr };
+        size_t size_{ 0 };
+#ifdef _WIN32
+        void*  mapping_{ nullptr };   ///< File-mapping handle.
+#endif
+    };
+
+} // namespace mpocv
@@ -0,0 +1,71 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "plot_command.h"
+
+namespace mpocv
+{
+
+    /**
+     * @enum MemoryPolicy
+     * @brief What a Figure does when adding a command would exceed its memory budget.
+     */
+    enum class MemoryPolicy
+    {
+        DecimateOldest, ///< Halve the point count of the oldest series until under budget
+        DropOldest,     ///< Remove the oldest commands until under budget
+        Throw           ///< Reject the new command with std::length_error
+    };
+
+    /**
+     * @struct MemoryUsage
+     * @brief Bytes retained by a Figure, as reported by Figure::memory_usage().
+     *
+     * Command bytes include the PlotCommand record itself plus every heap
+     * buffer it owns (point vectors, strings), measured by capacity.
+     */
+    struct MemoryUsage
+    {
+        /**
+         * @struct SeriesUsage
+         * @brief One command that holds point data.
+         */
+        struct SeriesUsage
+        {
+            int         subplot{ -1 };  ///< Subplot cell (0-based), or -1 for the figure itself
+            size_t      index{ 0 };     ///< Position in the command list
+            CmdType     type{ CmdType::Line };
+            std::string label;
+            size_t      points{ 0 };
+            size_t      bytes{ 0 };     ///< Command record plus its buffers
+        };
+
+        std::array<size_t, kCmdTypeCount> per_type{};  ///< Command bytes per CmdType
+        std::vector<SeriesUsage> series;               ///< Line / scatter / polygon commands
+        size_t command_slack{ 0 };  ///< Reserved but unused command-list capacity
+        size_t canvas{ 0 };         ///< Pixel buffer
+        size_t caches{ 0 };         ///< Render caches (rotated y-label, ...)
+
+        /// @brief Sum of per_type.
+        size_t commands() const
+        {
+            size_t n = 0;
+            for (size_t b : per_type) n += b;
+            return n;
+        }
+
+        /// @brief Everything above.
+        size_t total() const { return commands() + command_slack + canvas + caches; }
+    };
+
+} // namespace mpocv
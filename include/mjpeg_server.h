@@ -0,0 +1,97 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mpocv
+{
+
+    /**
+     * @class MjpegServer
+     * @brief Minimal MJPEG-over-HTTP server (multipart/x-mixed-replace).
+     *
+     * One accept thread and one sender thread per client. The producer
+     * publishes each JPEG once; every client sends the same shared bytes.
+     * Only the newest frame is kept: a client that is still sending an older
+     * frame skips straight to the latest one when it is done, so slow or
+     * stalled clients never hold up publish() (which only swaps a pointer
+     * under a short lock). Any request path is answered with the stream.
+     *
+     * Frame buffers are recycled once no client holds them any more, so a
+     * steady stream does not allocate.
+     */
+    class MjpegServer
+    {
+    public:
+        using Frame = std::shared_ptr<std::vector<uint8_t>>;
+
+        MjpegServer() = default;
+        ~MjpegServer();
+        MjpegServer(const MjpegServer&) = delete;
+        MjpegServer& operator=(const MjpegServer&) = delete;
+
+        /**
+         * @brief Listen on @p port and start serving.
+         *
+         * @param port        TCP port (0 picks a free one, see port()).
+         * @param bind_addr   IPv4 address to bind; loopback by default.
+         * @param max_clients Further connections are closed right away.
+         * @return false if the socket could not be bound (or a server is already running).
+         */
+        bool start(int port, const std::string& bind_addr = "127.0.0.1", int max_clients = 8);
+
+        /// @brief Disconnect all clients and stop listening. Safe to call repeatedly.
+        void stop();
+
+        bool running() const { return running_.load(); }   ///< True between start() and stop().
+        int  port() const { return port_; }                  ///< Bound port (valid while running).
+        int  clients() const { return clients_.load(); }     ///< Connected clients.
+
+        /// @brief An empty buffer to encode the next frame into (recycled when possible).
+        Frame acquire();
+
+        /// @brief Make @p jpeg the latest frame; returns immediately.
+        void publish(Frame jpeg);
+
+    private:
+        struct Client
+        {
+            intptr_t    sock{ -1 };
+            std::thread thread;
+            std::atomic<bool> done{ false };
+        };
+
+        void accept_loop();
+        void serve(Client& c);
+        void reap_clients(bool all);
+
+        std::atomic<bool>     running_{ false };
+        std::atomic<int>      clients_{ 0 };
+        intptr_t              listen_sock_{ -1 };
+        int                   port_{ 0 };
+        int                   max_clients_{ 8 };
+        std::thread           acceptor_;
+
+        std::mutex            mtx_;                ///< Guards everything below.
+        std::condition_variable frame_cv_;         ///< Signalled on publish() and stop().
+        Frame                 latest_;             ///< Newest frame, shared by all clients.
+        uint64_t              seq_{ 0 };           ///< Incremented per published frame.
+        std::vector<Frame>    pool_;               ///< Buffers for acquire().
+        std::vector<std::unique_ptr<Client>> conns_;
+    };
+
+} // namespace mpocv
@@ -0,0 +1,110 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace mpocv
+{
+
+    /**
+     * @class MpscQueue
+     * @brief Bounded lock-free multi-producer / single-consumer queue.
+     *
+     * A ring of slots, each carrying a sequence number that tells whether it
+     * is free for the producer claiming position @c pos (seq == pos) or holds
+     * a value for the consumer (seq == pos + 1). Producers claim a position
+     * with one CAS on the tail and never wait for each other; a full ring
+     * makes try_push() fail immediately and counts a drop instead of
+     * blocking. A single producer makes it an SPSC queue with the same code.
+     *
+     * try_pop() must only be called from one thread at a time.
+     */
+    template<typename T>
+    class MpscQueue
+    {
+    public:
+        /// @param capacity Slots in the ring; rounded up to a power of two (at least 2).
+        explicit MpscQueue(size_t capacity)
+        {
+            size_t n = 2;
+            while (n < capacity) n *= 2;
+            slots_.reset(new Slot[n]);
+            mask_ = n - 1;
+            for (size_t i = 0; i < n; ++i) slots_[i].seq.store(i, std::memory_order_relaxed);
+        }
+
+        MpscQueue(const MpscQueue&) = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        /// @brief Enqueue @p v; returns false (and counts a drop) if the ring is full.
+        template<typename U>
+        bool try_push(U&& v)
+        {
+            size_t pos = tail_.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Slot& s = slots_[pos & mask_];
+                const size_t seq = s.seq.load(std::memory_order_acquire);
+                const intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+                if (dif == 0)
+                {
+                    if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        s.value = std::forward<U>(v);
+                        s.seq.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (dif < 0)
+                {
+                    /* the consumer has not freed this slot yet: full */
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                else
+                {
+                    pos = tail_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /// @brief Dequeue into @p out; returns false if no published value is waiting.
+        bool try_pop(T& out)
+        {
+            Slot& s = slots_[head_ & mask_];
+            if (s.seq.load(std::memory_order_acquire) != head_ + 1) return false;
+            out = std::move(s.value);
+            s.value = T{};   /* release captured resources now, not on the next lap */
+            s.seq.store(head_ + mask_ + 1, std::memory_order_release);
+            ++head_;
+            return true;
+        }
+
+        size_t   capacity() const { return mask_ + 1; }   ///< Slots in the ring.
+        uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }   ///< Failed pushes so far.
+
+    private:
+        struct Slot
+        {
+            std::atomic<size_t> seq{ 0 };
+            T                   value{};
+        };
+
+        std::unique_ptr<Slot[]> slots_;
+        size_t                  mask_{ 0 };
+        alignas(64) std::atomic<size_t>   tail_{ 0 };      ///< Next position for producers.
+        alignas(64) size_t                head_{ 0 };      ///< Next position for the consumer.
+        alignas(64) std::atomic<uint64_t> dropped_{ 0 };
+    };
+
+} // namespace mpocv
@@ -0,0 +1,33 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#pragma once
+#include <cstddef>
+
+namespace mpocv
+{
+
+    /**
+     * @struct PickResult
+     * @brief Command and sample found by Figure::pick().
+     *
+     * For series commands @c index is the sample (for line matrices
+     * channel * x.size() + sample); for shapes it is 0 and @c x / @c y is
+     * the pick position itself.
+     */
+    struct PickResult
+    {
+        bool   found{ false };      ///< False if nothing lies within the radius.
+        int    subplot{ -1 };       ///< Cell of a subplot grid, -1 for the figure itself.
+        size_t command{ 0 };        ///< Index of the command, in insertion order.
+        size_t index{ 0 };          ///< Sample within the command.
+        double x{ 0.0 }, y{ 0.0 };  ///< Data coordinates of the sample.
+        double distance{ 0.0 };     ///< Distance from the pick position in pixels.
+    };
+
+} // namespace mpocv
@@ -7,9 +7,15 @@
 // =============================================================================
 
 #pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
 #include <string>
+#include <variant>
 #include <vector>
 #include "color.h"
+#include "colormap.h"
+#include "series.h"
 
 namespace mpocv
 {
@@ -28,17 +34,35 @@ namespace mpocv
         RectXYWH,     ///< Rectangle via [x, y, width, height]
         RotatedRect,  ///< Rotated rectangle
         Polygon,      ///< Arbitrary polygon
-        Ellipse       ///< Filled or outlined ellipse
+        Ellipse,      ///< Filled or outlined ellipse
+        Image,        ///< Scalar grid colorized through a colormap
+        Segments,     ///< Unconnected line segments (contour lines)
+        Histogram,    ///< Bars of binned sample counts
+        FillBetween,  ///< Filled band between two curves
+        LineMatrix    ///< Many polylines sharing one x vector
     };
 
+    /// Number of CmdType values (keep in sync with the last enumerator).
+    constexpr size_t kCmdTypeCount = static_cast<size_t>(CmdType::LineMatrix) + 1;
+
+    /// @brief Printable name of a command type.
+    inline const char* cmd_type_name(CmdType t)
+    {
+        static const char* const names[kCmdTypeCount] = {
+            "line", "scatter", "text", "circle", "rect_ltrb", "rect_xywh",
+            "rotated_rect", "polygon", "ellipse", "image", "segments", "histogram",
+            "fill_between", "line_matrix" };
+        return names[static_cast<size_t>(t)];
+    }
+
     /**
      * @struct LineData
      * @brief Data for a connected line plot (polyline).
      */
     struct LineData
     {
-        std::vector<double> x;   ///< X-coordinates
-        std::vector<double> y;   ///< Y-coordinates
+        Series x;                ///< X-coordinates
+        Series y;                ///< Y-coordinates
         float thickness{ 1.f };  ///< Line thickness in pixels
     };
 
@@ -48,9 +72,14 @@ namespace mpocv
      */
     struct ScatterData
     {
-        std::vector<double> x;      ///< X-coordinates
-        std::vector<double> y;      ///< Y-coordinates
+        Series x;                   ///< X-coordinates
+        Series y;                   ///< Y-coordinates
         float marker_size{ 4.f };   ///< Marker radius in pixels
+
+        /* optional per-point attributes (empty = use the command color / marker_size) */
+        Series   color_index;           ///< Per-point index 0-255 into cmap
+        Series   sizes;                 ///< Per-point marker radius in pixels
+        Colormap cmap{ Colormap::Viridis }; ///< Lookup table for color_index
     };
 
     /**
@@ -60,7 +89,7 @@ namespace mpocv
     struct TextData
     {
         double x{ 0 }, y{ 0 };                  ///< Anchor point in data coordinates
-        std::string text;                      ///< Text string to display
+        std::pmr::string text;                 ///< Text string to display
         double font_scale{ 0.4 };              ///< Font scale (OpenCV scalar)
         int thickness{ 1 };                    ///< Stroke thickness
         enum class HAlign { Left, Center, Right } halign{ HAlign::Left }; ///< Horizontal alignment
@@ -118,8 +147,8 @@ namespace mpocv
      */
     struct PolygonData
     {
-        std::vector<double> x;   ///< X-coordinates of polygon vertices
-        std::vector<double> y;   ///< Y-coordinates of polygon vertices
+        Series x;                ///< X-coordinates of polygon vertices
+        Series y;                ///< Y-coordinates of polygon vertices
         ShapeStyle style;        ///< Fill and stroke settings
     };
 
@@ -135,27 +164,189 @@ namespace mpocv
         ShapeStyle style;        ///< Fill and stroke settings
     };
 
+    /**
+     * @enum ImageInterp
+     * @brief Resampling used when an image grid is scaled onto the canvas.
+     */
+    enum class ImageInterp : uint8_t
+    {
+        Nearest,      ///< Each cell is a flat block (exact values)
+        Bilinear      ///< Smooth between cell centers (area-averaged when shrinking)
+    };
+
+    /**
+     * @struct ImageData
+     * @brief Grid of scalar values drawn into a data-space extent.
+     *
+     * Row 0 is drawn at the top of the extent (y1), like an image. The
+     * values never change after the command is created, so the colorized
+     * pixels can be cached for as long as the axes stay the same.
+     */
+    struct ImageData
+    {
+        Series values;                          ///< rows * cols samples, row-major
+        int rows{ 0 }, cols{ 0 };               ///< Grid shape
+        double x0{ 0 }, y0{ 0 }, x1{ 1 }, y1{ 1 }; ///< Outer cell edges in data coordinates (x0 < x1, y0 < y1)
+        double vmin{ 0 }, vmax{ 1 };            ///< Values mapped to the first / last colormap entry
+        Colormap cmap{ Colormap::Viridis };     ///< Lookup table
+        ImageInterp interp{ ImageInterp::Nearest }; ///< Resampling
+        uint64_t id{ 0 };                       ///< Key of the colorized cache entry
+    };
+
+    /**
+     * @struct SegmentData
+     * @brief Collection of unconnected line segments, e.g. contour lines.
+     *
+     * Segment k joins stored points 2k and 2k + 1. Points are stored compactly
+     * (contours keep float grid coordinates) and mapped to data space with a
+     * per-axis scale and offset when drawn: x_data = ox + sx * x.
+     */
+    struct SegmentData
+    {
+        Series x;                            ///< Stored x of the end points
+        Series y;                            ///< Stored y of the end points
+        double ox{ 0 }, oy{ 0 };             ///< Data position of stored (0, 0)
+        double sx{ 1 }, sy{ 1 };             ///< Data units per stored unit
+        float thickness{ 1.f };              ///< Line thickness in pixels
+        Series   color_index;                ///< Per-segment index 0-255 into cmap (empty = command color)
+        Colormap cmap{ Colormap::Viridis };  ///< Lookup table for color_index
+    };
+
+    /**
+     * @struct HistData
+     * @brief Raw samples binned into bars at render time.
+     *
+     * The bins span the data range while the x-axis autoscales and the
+     * visible x-range otherwise, so changing the limits re-bins the same
+     * samples. Counts are cached per command under @c id.
+     */
+    struct HistData
+    {
+        Series     data;                     ///< Samples to bin
+        int        bins{ 10 };               ///< Number of equal-width bins
+        ShapeStyle style;                    ///< Bar fill and outline
+        uint64_t   id{ 0 };                  ///< Key of the cached counts
+    };
+
+    /**
+     * @struct FillBetweenData
+     * @brief Band between a lower and an upper curve sampled at the same x.
+     */
+    struct FillBetweenData
+    {
+        Series     x;                        ///< Shared x-coordinates
+        Series     y_lo;                     ///< Lower curve
+        Series     y_hi;                     ///< Upper curve
+        ShapeStyle style;                    ///< Fill and outline settings
+    };
+
+    /**
+     * @struct LineMatrixData
+     * @brief Polylines of several channels sampled at one shared x vector.
+     *
+     * Channel k holds samples [k * n, (k + 1) * n) of @c y, n = x.size(), so
+     * x is stored (and mapped to pixels) once for all channels.
+     */
+    struct LineMatrixData
+    {
+        Series   x;                          ///< Shared x-coordinates
+        Series   y;                          ///< channels * x.size() samples, channel-major
+        int      channels{ 0 };              ///< Number of polylines
+        float    thickness{ 1.f };           ///< Line thickness in pixels
+        Colormap cmap{ Colormap::Tab10 };    ///< Channel colors (see channel_color())
+
+        /// @brief Samples of channel @p k (a view; valid while this command lives).
+        Series channel(int k) const
+        {
+            const size_t n = x.size();
+            return Series::view(static_cast<const unsigned char*>(y.raw_data()) + static_cast<size_t>(k) * n * y.stride(),
+                n, y.type(), y.stride());
+        }
+
+        /// @brief Color of channel @p k: Tab10 cycles, other maps spread the channels over the table.
+        Color channel_color(int k) const
+        {
+            const Color* lut = colormap_lut(cmap);
+            if (cmap == Colormap::Tab10) return lut[k % 10];
+            return lut[channels > 1 ? k * 255 / (channels - 1) : 0];
+        }
+    };
+
     /**
      * @struct PlotCommand
-     * @brief Union-like container for a single drawing command.
+     * @brief Tagged container for a single drawing command.
      *
-     * The actual command is specified by `type`, and the corresponding
-     * field (line, scatter, etc.) is used based on that.
+     * `type` selects the command; its payload lives in a std::variant, so a
+     * command is only as large as its biggest payload rather than the sum of
+     * all of them. Access the payload through the accessor named after the
+     * type (line(), scatter(), ...); asking for another type throws
+     * std::bad_variant_access. Both rectangle types share RectData.
+     *
+     * Strings are allocated from the memory resource passed at construction;
+     * Series payloads carry their own allocation (see Series).
      */
     struct PlotCommand
     {
+        using Payload = std::variant<LineData, ScatterData, TextData, CircleData, RectData,
+            RotatedRectData, PolygonData, EllipseData, ImageData, SegmentData, HistData,
+            FillBetweenData, LineMatrixData>;
+
+        PlotCommand() = default;
+
+        /// @brief Construct a command of type @p t with a default payload; strings come from @p mr.
+        PlotCommand(CmdType t, std::pmr::memory_resource* mr)
+            : type(t), label(mr)
+        {
+            switch (t)
+            {
+            case CmdType::Line:        payload.emplace<LineData>(); break;
+            case CmdType::Scatter:     payload.emplace<ScatterData>(); break;
+            case CmdType::Text:        payload.emplace<TextData>(TextData{ 0.0, 0.0, std::pmr::string(mr) }); break;
+            case CmdType::Circle:      payload.emplace<CircleData>(); break;
+            case CmdType::RectLTRB:
+            case CmdType::RectXYWH:    payload.emplace<RectData>(); break;
+            case CmdType::RotatedRect: payload.emplace<RotatedRectData>(); break;
+            case CmdType::Polygon:     payload.emplace<PolygonData>(); break;
+            case CmdType::Ellipse:     payload.emplace<EllipseData>(); break;
+            case CmdType::Image:       payload.emplace<ImageData>(); break;
+            case CmdType::Segments:    payload.emplace<SegmentData>(); break;
+            case CmdType::Histogram:   payload.emplace<HistData>(); break;
+            case CmdType::FillBetween: payload.emplace<FillBetweenData>(); break;
+            case CmdType::LineMatrix:  payload.emplace<LineMatrixData>(); break;
+            }
+        }
+
         CmdType type{ CmdType::Line };  ///< Active drawing type
         Color   color{ Color::Blue() }; ///< Optional fallback / stroke color
-        std::string label;              ///< For legend
-
-        LineData        line;
-        ScatterData     scatter;
-        TextData        txt;
-        CircleData      circle;
-        RectData        rect;
-        RotatedRectData rot_rect;
-        PolygonData     polygon;
-        EllipseData     ellipse;
+        std::pmr::string label;         ///< For legend
+        Payload payload;                ///< Data of the active type
+
+        LineData&              line()           { return std::get<LineData>(payload); }
+        const LineData&        line() const     { return std::get<LineData>(payload); }
+        ScatterData&           scatter()        { return std::get<ScatterData>(payload); }
+        const ScatterData&     scatter() const  { return std::get<ScatterData>(payload); }
+        TextData&              txt()            { return std::get<TextData>(payload); }
+        const TextData&        txt() const      { return std::get<TextData>(payload); }
+        CircleData&            circle()         { return std::get<CircleData>(payload); }
+        const CircleData&      circle() const   { return std::get<CircleData>(payload); }
+        RectData&              rect()           { return std::get<RectData>(payload); }
+        const RectData&        rect() const     { return std::get<RectData>(payload); }
+        RotatedRectData&       rot_rect()       { return std::get<RotatedRectData>(payload); }
+        const RotatedRectData& rot_rect() const { return std::get<RotatedRectData>(payload); }
+        PolygonData&           polygon()        { return std::get<PolygonData>(payload); }
+        const PolygonData&     polygon() const  { return std::get<PolygonData>(payload); }
+        EllipseData&           ellipse()        { return std::get<EllipseData>(payload); }
+        const EllipseData&     ellipse() const  { return std::get<EllipseData>(payload); }
+        ImageData&             image()          { return std::get<ImageData>(payload); }
+        const ImageData&       image() const    { return std::get<ImageData>(payload); }
+        SegmentData&           segments()       { return std::get<SegmentData>(payload); }
+        const SegmentData&     segments() const { return std::get<SegmentData>(payload); }
+        HistData&              hist()           { return std::get<HistData>(payload); }
+        const HistData&        hist() const     { return std::get<HistData>(payload); }
+        FillBetweenData&       band()           { return std::get<FillBetweenData>(payload); }
+        const FillBetweenData& band() const     { return std::get<FillBetweenData>(payload); }
+        LineMatrixData&        matrix()         { return std::get<LineMatrixData>(payload); }
+        const LineMatrixData&  matrix() const   { return std::get<LineMatrixData>(payload); }
     };
 
 } // namespace mpocv
@@ -0,0 +1,40 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#pragma once
+#include <cstddef>
+
+namespace mpocv
+{
+
+    /**
+     * @struct RenderProgress
+     * @brief State of a progressive render, as returned by Figure::render_progressive().
+     *
+     * A progressive render runs several passes over the commands, each
+     * drawing series at half the sample stride of the previous one; the last
+     * pass draws every point. The canvas always shows the most recent
+     * complete pass.
+     */
+    struct RenderProgress
+    {
+        int    pass{ 0 };         ///< Passes completed (shown on the canvas).
+        int    passes{ 0 };       ///< Passes in total.
+        size_t stride{ 1 };       ///< Sample stride of the pass in progress (1 = full detail).
+        size_t work_done{ 0 };    ///< Work units (points or commands) drawn so far, all passes.
+        size_t work_total{ 0 };   ///< Work units of all passes.
+        bool   complete{ true };  ///< True once the full-detail pass is on the canvas.
+
+        /// @brief Completed share of the total work in [0, 1].
+        double fraction() const
+        {
+            return work_total == 0 ? 1.0 : static_cast<double>(work_done) / static_cast<double>(work_total);
+        }
+    };
+
+} // namespace mpocv
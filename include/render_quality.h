@@ -0,0 +1,28 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#pragma once
+
+namespace mpocv
+{
+
+    /**
+     * @enum RenderQuality
+     * @brief Speed / quality trade-off of the raster renderer.
+     *
+     * Horizontal and vertical lines and upright rectangles are never
+     * anti-aliased: their edges fall on pixel boundaries, so AA only costs time.
+     */
+    enum class RenderQuality
+    {
+        Draft,   ///< No anti-aliasing at all; for interactive previews.
+        Normal,  ///< Anti-aliased curves, slanted lines and text; tiny markers without AA.
+        Final    ///< Anti-aliasing on everything that benefits; used by save().
+    };
+
+} // namespace mpocv
@@ -0,0 +1,81 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include "plot_command.h"
+
+namespace mpocv
+{
+
+    /**
+     * @enum RenderStage
+     * @brief Pipeline stages of Figure::render(), in execution order.
+     */
+    enum class RenderStage
+    {
+        Autoscale,  ///< Limits from data bounds, padding and equal-scale
+        Ticks,      ///< make_ticks() for both axes
+        Clear,      ///< Canvas fill with the background color
+        Grid,       ///< draw_grid()
+        Axes,       ///< draw_axes() (axis lines, ticks, tick labels)
+        Commands,   ///< Retained command loop
+        Legend,     ///< Legend box
+        Labels      ///< Title, x-label and the rotated y-label
+    };
+
+    /// Number of RenderStage values.
+    constexpr size_t kRenderStageCount = static_cast<size_t>(RenderStage::Labels) + 1;
+
+    /**
+     * @struct RenderStats
+     * @brief Timings and counters collected by the last Figure::render().
+     *
+     * Only filled while collection is enabled (Figure::collect_stats()). All
+     * times are wall-clock nanoseconds. For a figure split into subplots the
+     * per-stage and per-command fields are summed over all redrawn cells,
+     * while total_ns is the wall time of the whole parallel render.
+     */
+    struct RenderStats
+    {
+        double total_ns{ 0 };                                   ///< Whole render() call
+        std::array<double, kRenderStageCount> stage_ns{};       ///< Per RenderStage
+        std::array<double, kCmdTypeCount>     cmd_ns{};         ///< Per CmdType, inside the command stage
+        std::array<size_t, kCmdTypeCount>     cmd_count{};      ///< Commands drawn per CmdType
+
+        size_t primitives_drawn{ 0 };    ///< cv::line / circle / fill / putText calls for commands
+        size_t points_culled{ 0 };       ///< Segments or markers skipped as entirely off-canvas
+        size_t full_canvas_blends{ 0 };  ///< Translucent fills blended over the full canvas
+
+        /// @brief Time spent in stage @p s (ns).
+        double stage(RenderStage s) const { return stage_ns[static_cast<size_t>(s)]; }
+
+        /// @brief Zero every field.
+        void reset() { *this = RenderStats{}; }
+
+        /// @brief Accumulate another set of stats (used to merge subplot cells).
+        void add(const RenderStats& o)
+        {
+            for (size_t i = 0; i < kRenderStageCount; ++i) stage_ns[i] += o.stage_ns[i];
+            for (size_t i = 0; i < kCmdTypeCount; ++i) { cmd_ns[i] += o.cmd_ns[i]; cmd_count[i] += o.cmd_count[i]; }
+            primitives_drawn += o.primitives_drawn;
+            points_culled += o.points_culled;
+            full_canvas_blends += o.full_canvas_blends;
+        }
+
+        /// @brief Printable name of a stage.
+        static const char* stage_name(RenderStage s)
+        {
+            static const char* const names[kRenderStageCount] = {
+                "autoscale", "ticks", "clear", "grid", "axes", "commands", "legend", "labels" };
+            return names[static_cast<size_t>(s)];
+        }
+    };
+
+} // namespace mpocv
@@ -0,0 +1,221 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace mpocv
+{
+
+    /**
+     * @enum SampleType
+     * @brief Element type of the values a Series refers to.
+     */
+    enum class SampleType : unsigned char
+    {
+        Float64,    ///< double
+        Float32,    ///< float (widened to double on read)
+        UInt8       ///< unsigned char, e.g. colormap indices
+    };
+
+    /**
+     * @class Series
+     * @brief Read-only array of sample values used by series commands.
+     *
+     * A Series either adopts a moved-in std::vector (no copy), owns a copy
+     * allocated from a std::pmr::memory_resource, or views external memory
+     * such as a memory-mapped file. Copies of a Series share the same buffer,
+     * so copying a PlotCommand never duplicates point data.
+     *
+     * Views may hold float or double samples with an arbitrary byte stride
+     * (e.g. one column of an interleaved recording); owned buffers are
+     * contiguous doubles, or contiguous bytes / floats when built from a
+     * byte buffer. Use operator[] for element access; data() is only
+     * available for contiguous double storage.
+     *
+     * When the buffer comes from a memory resource, that resource must outlive
+     * every Series (and every Figure) referring to it.
+     */
+    class Series
+    {
+    public:
+        Series() = default;
+
+        /**
+         * @brief Adopt a vector's buffer without copying.
+         *
+         * @param v Values; left empty.
+         */
+        Series(std::vector<double>&& v)
+        {
+            auto owned = std::make_shared<std::vector<double>>(std::move(v));
+            data_ = owned->data();
+            size_ = owned->size();
+            owned_bytes_ = owned->capacity() * sizeof(double);
+            owner_ = std::move(owned);
+        }
+
+        /**
+         * @brief Copy values into a buffer allocated from @p mr.
+         *
+         * The buffer and its bookkeeping both come from @p mr, so a monotonic
+         * arena releases them together.
+         *
+         * @param p  First value.
+         * @param n  Number of values.
+         * @param mr Memory resource for the copy.
+         */
+        explicit Series(const double* p, size_t n, std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+        {
+            using Buffer = std::pmr::vector<double>;
+            auto owned = std::allocate_shared<Buffer>(std::pmr::polymorphic_allocator<Buffer>(mr), p, p + n);
+            data_ = owned->data();
+            size_ = n;
+            owned_bytes_ = n * sizeof(double);
+            owner_ = std::move(owned);
+        }
+
+        /**
+         * @brief Copy a vector into a buffer allocated from @p mr.
+         */
+        Series(const std::vector<double>& v, std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+            : Series(v.data(), v.size(), mr)
+        {}
+
+        /**
+         * @brief Share the first @p n values of a growable buffer.
+         *
+         * Values past @p n may be appended later without reallocating and
+         * published by wrapping the buffer again with a larger @p n; copies
+         * made earlier keep seeing their first @p n values. The whole
+         * capacity counts as owned.
+         */
+        Series(std::shared_ptr<const std::pmr::vector<double>> buf, size_t n)
+        {
+            data_ = buf->data();
+            size_ = n;
+            owned_bytes_ = buf->capacity() * sizeof(double);
+            owner_ = std::move(buf);
+        }
+
+        /**
+         * @brief Share a byte buffer holding contiguous samples of @p type.
+         *
+         * The default UInt8 suits colormap indices; image grids also keep
+         * float samples this way instead of widening them to double.
+         *
+         * @param bytes Buffer, typically allocated from a Figure's memory resource.
+         * @param type  Element type of the samples in @p bytes.
+         */
+        explicit Series(std::shared_ptr<const std::pmr::vector<unsigned char>> bytes,
+            SampleType type = SampleType::UInt8)
+        {
+            stride_ = sample_size(type);
+            data_ = bytes->data();
+            size_ = bytes->size() / stride_;
+            type_ = type;
+            owned_bytes_ = bytes->size();
+            owner_ = std::move(bytes);
+        }
+
+        /**
+         * @brief Wrap external memory without copying.
+         *
+         * @param p     First value.
+         * @param n     Number of values.
+         * @param owner Object that keeps @p p valid (e.g. a MappedFile); may be
+         *              empty if the caller guarantees the lifetime.
+         */
+        static Series view(const double* p, size_t n, std::shared_ptr<const void> owner = {})
+        {
+            return view(p, n, SampleType::Float64, sizeof(double), std::move(owner));
+        }
+
+        /**
+         * @brief Wrap strided external samples of type @p type without copying.
+         *
+         * @param p      First sample.
+         * @param n      Number of samples.
+         * @param type   Element type.
+         * @param stride Distance between consecutive samples in bytes.
+         * @param owner  Object that keeps @p p valid; may be empty.
+         */
+        static Series view(const void* p, size_t n, SampleType type, size_t stride,
+            std::shared_ptr<const void> owner = {})
+        {
+            Series s;
+            s.owner_ = std::move(owner);
+            s.data_ = p;
+            s.size_ = n;
+            s.type_ = type;
+            s.stride_ = stride;
+            s.view_ = true;
+            return s;
+        }
+
+        size_t size() const { return size_; }
+        bool   empty() const { return size_ == 0; }
+
+        double operator[](size_t i) const
+        {
+            const unsigned char* p = static_cast<const unsigned char*>(data_) + i * stride_;
+            if (type_ == SampleType::Float64)
+            {
+                double v;
+                std::memcpy(&v, p, sizeof v);   /* unaligned-safe; compiles to a plain load */
+                return v;
+            }
+            if (type_ == SampleType::UInt8) return *p;
+            float v;
+            std::memcpy(&v, p, sizeof v);
+            return v;
+        }
+        double back() const { return (*this)[size_ - 1]; }
+
+        /// @brief True if the values are contiguous doubles (data() is usable).
+        bool contiguous() const { return type_ == SampleType::Float64 && stride_ == sizeof(double); }
+
+        /// @brief Contiguous values, or nullptr for float / strided views.
+        const double* data() const { return contiguous() ? static_cast<const double*>(data_) : nullptr; }
+
+        /// @brief Element type of the underlying samples.
+        SampleType type() const { return type_; }
+
+        /// @brief True if this Series refers to external memory (see view()).
+        bool is_view() const { return view_; }
+
+        /// @brief Bytes of the buffer owned by this Series (shared with its copies).
+        size_t owned_bytes() const { return owned_bytes_; }
+
+        /// @brief First sample in its stored type (see type() and stride()).
+        const void* raw_data() const { return data_; }
+
+        /// @brief Distance between consecutive samples in bytes.
+        size_t stride() const { return stride_; }
+
+        /// @brief Size in bytes of one sample of type @p t.
+        static size_t sample_size(SampleType t)
+        {
+            return t == SampleType::Float64 ? sizeof(double) : t == SampleType::Float32 ? sizeof(float) : 1;
+        }
+
+    private:
+        std::shared_ptr<const void> owner_;        ///< Keeps the buffer alive.
+        const void*                 data_{ nullptr };
+        size_t                      size_{ 0 };
+        size_t                      stride_{ sizeof(double) }; ///< Bytes between samples.
+        size_t                      owned_bytes_{ 0 };
+        SampleType                  type_{ SampleType::Float64 };
+        bool                        view_{ false };
+    };
+
+} // namespace mpocv
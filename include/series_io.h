@@ -0,0 +1,51 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#pragma once
+#include <cstddef>
+#include <string>
+
+#include "series.h"
+
+namespace mpocv
+{
+
+    /**
+     * @brief Map a NumPy .npy file and return a zero-copy view of one column.
+     *
+     * Supports little-endian float32 / float64 arrays of shape (N,) or (N, C),
+     * in C or Fortran order, format versions 1-3. The file is memory-mapped;
+     * pages are only read when the samples are accessed (first autoscaling
+     * render or draw), and the mapping lives as long as the returned Series
+     * or any copy of it.
+     *
+     * @param filename Path of the .npy file.
+     * @param column   Column of a 2-D array (0 for 1-D arrays).
+     * @return Series View of the samples, or an empty Series if the file cannot
+     *         be mapped or is not a supported array.
+     */
+    Series load_npy(const std::string& filename, size_t column = 0);
+
+    /**
+     * @brief Map a raw little-endian sample dump and return a zero-copy view of one channel.
+     *
+     * The file holds interleaved frames of @p channels samples of @p type,
+     * starting @p offset bytes into the file. A trailing partial frame is
+     * ignored. Mapping and lifetime are as for load_npy().
+     *
+     * @param filename Path of the raw file.
+     * @param type     Sample type.
+     * @param channels Samples per frame.
+     * @param channel  Channel to view (0-based).
+     * @param offset   Bytes to skip at the start of the file (e.g. a header).
+     * @return Series View of the channel, or an empty Series on failure.
+     */
+    Series load_raw(const std::string& filename, SampleType type,
+        size_t channels = 1, size_t channel = 0, size_t offset = 0);
+
+} // namespace mpocv
@@ -0,0 +1,102 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#pragma once
+#include <opencv2/core.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * @file shm_ring.h
+ * @brief Frame ring in POSIX shared memory, for displaying figures in another process.
+ *
+ * The segment holds a small header and a fixed number of frame slots. The
+ * publisher writes frames round-robin; each slot is guarded by a seqlock
+ * (odd sequence while it is being written), so the publisher never waits
+ * for a reader and a reader detects and retries a torn copy instead of
+ * locking. The header counts published frames, which tells a reader which
+ * slot is newest. Not available on Windows (create() / open() return
+ * nullptr).
+ */
+
+namespace mpocv
+{
+
+    /**
+     * @class ShmPublisher
+     * @brief Writer side of a shared-memory frame ring.
+     */
+    class ShmPublisher
+    {
+    public:
+        /**
+         * @brief Create (or replace) the segment @p name.
+         *
+         * @param name       Segment name; a leading '/' is added if missing.
+         * @param slot_bytes Largest frame in bytes (rows * cols * elemSize).
+         * @param slots      Frame slots in the ring (at least 2).
+         * @return The publisher, or nullptr if the segment could not be created.
+         */
+        static std::unique_ptr<ShmPublisher> create(const std::string& name, size_t slot_bytes, int slots = 3);
+
+        /// Unmaps and unlinks the segment; readers keep their mapping until they close it.
+        ~ShmPublisher();
+        ShmPublisher(const ShmPublisher&) = delete;
+        ShmPublisher& operator=(const ShmPublisher&) = delete;
+
+        /**
+         * @brief Copy @p frame into the next slot and make it the newest frame.
+         * @return false if the frame is larger than a slot (it is skipped).
+         */
+        bool publish(const cv::Mat& frame);
+
+        uint64_t frames() const;   ///< Frames published so far.
+
+    private:
+        ShmPublisher() = default;
+
+        std::string name_;
+        void*       base_{ nullptr };
+        size_t      size_{ 0 };
+    };
+
+    /**
+     * @class ShmReader
+     * @brief Reader side of a shared-memory frame ring (see ShmPublisher).
+     */
+    class ShmReader
+    {
+    public:
+        /// @brief Map the existing segment @p name; nullptr if it does not exist or is not a ring.
+        static std::unique_ptr<ShmReader> open(const std::string& name);
+
+        ~ShmReader();
+        ShmReader(const ShmReader&) = delete;
+        ShmReader& operator=(const ShmReader&) = delete;
+
+        /**
+         * @brief Copy the newest frame into @p out if it is newer than frame @p after.
+         *
+         * @param out   Reallocated only when the frame size or type changes.
+         * @param after Last frame number seen (0 for none).
+         * @return The frame number copied, or 0 if there is nothing newer or
+         *         every attempt raced with the publisher.
+         */
+        uint64_t read_latest(cv::Mat& out, uint64_t after = 0);
+
+    private:
+        ShmReader() = default;
+
+        void*  base_{ nullptr };
+        size_t size_{ 0 };
+    };
+
+} // namespace mpocv
@@ -0,0 +1,84 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mpocv
+{
+
+    /**
+     * @class SpatialGrid
+     * @brief Uniform grid of 64-bit keys bucketed by 2-D position.
+     *
+     * The grid covers a rectangle fixed at reset(); points outside it land in
+     * the border cells, so later appends never need a rebuild to stay correct
+     * (only to stay fast). Queries visit the cells overlapping a rectangle and
+     * report every key stored there; callers do the exact distance test.
+     */
+    class SpatialGrid
+    {
+    public:
+        /**
+         * @brief Drop all keys and lay out cells over [xmin, xmax] x [ymin, ymax].
+         *
+         * @param expected Number of points the cell count is sized for
+         *                 (about kPointsPerCell per cell).
+         */
+        void reset(double xmin, double xmax, double ymin, double ymax, size_t expected);
+
+        /// @brief Add @p key at (x, y); non-finite positions are ignored.
+        void insert(double x, double y, uint64_t key)
+        {
+            if (std::isfinite(x) && std::isfinite(y) && !cells_.empty())
+            {
+                cells_[static_cast<size_t>(cell_y(y)) * nx_ + cell_x(x)].push_back(key);
+                ++size_;
+            }
+        }
+
+        /// @brief Calls f(key) for every key in the cells overlapping [x0, x1] x [y0, y1].
+        template<typename F>
+        void query(double x0, double x1, double y0, double y1, F&& f) const
+        {
+            if (cells_.empty()) return;
+            const int cx0 = cell_x(x0), cx1 = cell_x(x1);
+            const int cy0 = cell_y(y0), cy1 = cell_y(y1);
+            for (int cy = cy0; cy <= cy1; ++cy)
+                for (int cx = cx0; cx <= cx1; ++cx)
+                    for (uint64_t key : cells_[static_cast<size_t>(cy) * nx_ + cx]) f(key);
+        }
+
+        size_t size() const { return size_; }     ///< Keys stored.
+        bool   empty() const { return size_ == 0; }
+
+        /// @brief Heap bytes held by the cells.
+        size_t memory_bytes() const;
+
+        static constexpr size_t kPointsPerCell = 8;   ///< Target occupancy used by reset().
+
+    private:
+        int cell_x(double x) const { return clamp_cell((x - x0_) * inv_w_, nx_); }
+        int cell_y(double y) const { return clamp_cell((y - y0_) * inv_h_, ny_); }
+
+        static int clamp_cell(double t, int n)
+        {
+            return t > 0.0 ? (t < n - 1 ? static_cast<int>(t) : n - 1) : 0;   /* NaN -> 0 */
+        }
+
+        double x0_{ 0 }, y0_{ 0 };            ///< Lower-left corner of the grid.
+        double inv_w_{ 1 }, inv_h_{ 1 };      ///< Cells per data unit.
+        int    nx_{ 0 }, ny_{ 0 };            ///< Cells per axis.
+        size_t size_{ 0 };
+        std::vector<std::vector<uint64_t>> cells_;   ///< Row-major, ny_ * nx_.
+    };
+
+} // namespace mpocv
@@ -0,0 +1,103 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#pragma once
+#include <cstdint>
+#include <string>
+
+/**
+ * @file trace.h
+ * @brief Optional Chrome / Perfetto trace-event recording.
+ *
+ * Tracing is compiled in only when MPOCV_ENABLE_TRACING is defined (CMake
+ * option MPOCV_TRACING). Otherwise MPOCV_TRACE_SCOPE expands to nothing and
+ * the Tracer functions are empty inline stubs.
+ *
+ * Each thread appends complete ("X") events to its own fixed-size buffer
+ * without locks; only the first event of a thread (buffer registration) and
+ * Tracer::write_json() take a mutex. Events beyond a buffer's capacity are
+ * counted as dropped. Open the written file in chrome://tracing or
+ * https://ui.perfetto.dev.
+ */
+
+namespace mpocv
+{
+
+#ifdef MPOCV_ENABLE_TRACING
+
+    /**
+     * @class Tracer
+     * @brief Process-wide control of the trace-event recorder.
+     */
+    class Tracer
+    {
+    public:
+        /// @brief Pause (false) or resume (true) recording. Recording starts enabled.
+        static void enable(bool on = true);
+
+        /// @brief True while events are being recorded.
+        static bool enabled();
+
+        /**
+         * @brief Write all recorded events as Chrome trace-event JSON.
+         *
+         * Safe to call while other threads are still recording; events that
+         * are published after the snapshot of a buffer are not included.
+         *
+         * @param filename Output path (e.g. "render.trace.json").
+         * @return true if the file was written.
+         */
+        static bool write_json(const std::string& filename);
+
+        /// @brief Discard recorded events. Call only while no thread is recording.
+        static void clear();
+
+        /// @brief Number of events dropped because a thread buffer was full.
+        static uint64_t dropped();
+    };
+
+    /**
+     * @class TraceScope
+     * @brief Records one complete event spanning its own lifetime.
+     *
+     * @p name must outlive the trace (use string literals or static strings).
+     */
+    class TraceScope
+    {
+    public:
+        explicit TraceScope(const char* name);
+        ~TraceScope();
+        TraceScope(const TraceScope&) = delete;
+        TraceScope& operator=(const TraceScope&) = delete;
+    private:
+        const char* name_;
+        int64_t     t0_ns_;
+    };
+
+#define MPOCV_TRACE_CONCAT_(a, b) a##b
+#define MPOCV_TRACE_CONCAT(a, b) MPOCV_TRACE_CONCAT_(a, b)
+    /// Record a trace event covering the rest of the enclosing scope.
+#define MPOCV_TRACE_SCOPE(name) ::mpocv::TraceScope MPOCV_TRACE_CONCAT(mpocv_trace_scope_, __LINE__)(name)
+
+#else
+
+    class Tracer
+    {
+    public:
+        static void enable(bool = true) {}
+        static bool enabled() { return false; }
+        static bool write_json(const std::string&) { return false; }
+        static void clear() {}
+        static uint64_t dropped() { return 0; }
+    };
+
+#define MPOCV_TRACE_SCOPE(name) ((void)0)
+
+#endif
+
+} // namespace mpocv
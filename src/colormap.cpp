@@ -0,0 +1,89 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#include "colormap.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+namespace mpocv
+{
+    namespace
+    {
+        using Lut = std::array<Color, 256>;
+
+        /// Piecewise-linear table through @p n evenly spaced anchor colors.
+        Lut interpolate(const Color* anchors, size_t n)
+        {
+            Lut lut;
+            for (int i = 0; i < 256; ++i)
+            {
+                const double t = i / 255.0 * static_cast<double>(n - 1);
+                const size_t k = std::min(static_cast<size_t>(t), n - 2);
+                const double f = t - static_cast<double>(k);
+                auto mix = [f](uint8_t a, uint8_t b)
+                    {
+                        return static_cast<uint8_t>(a + (b - a) * f + 0.5);
+                    };
+                lut[i] = { mix(anchors[k].r, anchors[k + 1].r),
+                           mix(anchors[k].g, anchors[k + 1].g),
+                           mix(anchors[k].b, anchors[k + 1].b) };
+            }
+            return lut;
+        }
+
+        Lut make_viridis()
+        {
+            static const Color a[] = {
+                { 68, 1, 84 }, { 72, 40, 120 }, { 62, 74, 137 }, { 49, 104, 142 }, { 38, 130, 142 },
+                { 31, 158, 137 }, { 53, 183, 121 }, { 110, 206, 88 }, { 181, 222, 43 }, { 253, 231, 37 } };
+            return interpolate(a, sizeof(a) / sizeof(a[0]));
+        }
+
+        Lut make_jet()
+        {
+            static const Color a[] = {
+                { 0, 0, 128 }, { 0, 0, 255 }, { 0, 128, 255 }, { 0, 255, 255 }, { 128, 255, 128 },
+                { 255, 255, 0 }, { 255, 128, 0 }, { 255, 0, 0 }, { 128, 0, 0 } };
+            return interpolate(a, sizeof(a) / sizeof(a[0]));
+        }
+
+        Lut make_gray()
+        {
+            static const Color a[] = { { 0, 0, 0 }, { 255, 255, 255 } };
+            return interpolate(a, 2);
+        }
+
+        Lut make_tab10()
+        {
+            static const Color a[] = {
+                { 31, 119, 180 }, { 255, 127, 14 }, { 44, 160, 44 }, { 214, 39, 40 }, { 148, 103, 189 },
+                { 140, 86, 75 }, { 227, 119, 194 }, { 127, 127, 127 }, { 188, 189, 34 }, { 23, 190, 207 } };
+            Lut lut;
+            for (size_t i = 0; i < lut.size(); ++i) lut[i] = a[i % 10];
+            return lut;
+        }
+    } // namespace
+
+    const Color* colormap_lut(Colormap map)
+    {
+        static const Lut viridis = make_viridis();
+        static const Lut jet = make_jet();
+        static const Lut gray = make_gray();
+        static const Lut tab10 = make_tab10();
+        switch (map)
+        {
+        case Colormap::Jet:   return jet.data();
+        case Colormap::Gray:  return gray.data();
+        case Colormap::Tab10: return tab10.data();
+        default:              return viridis.data();
+        }
+    }
+
+} // namespace mpocv
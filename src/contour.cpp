@@ -0,0 +1,138 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+// Marching squares.
+//
+// Each cell between rows r, r + 1 and columns c, c + 1 is classified by which
+// corners lie at or above the level; the 4-bit case selects the cell edges
+// the iso-line crosses, and the crossing points are interpolated linearly
+// along those edges. Cells are independent, so bands of rows run in parallel.
+
+#include "contour.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mpocv
+{
+    namespace
+    {
+        /// Edges crossed per case (corner bits tl=8 tr=4 br=2 bl=1; edges T=0 R=1 B=2 L=3); saddles 5 / 10 handled apart.
+        constexpr signed char kCaseEdges[16][2] = {
+            { -1, -1 }, { 3, 2 }, { 2, 1 }, { 3, 1 }, { 0, 1 }, { -1, -1 }, { 0, 2 }, { 0, 3 },
+            { 0, 3 },   { 0, 2 }, { -1, -1 }, { 0, 1 }, { 3, 1 }, { 2, 1 }, { 3, 2 }, { -1, -1 } };
+
+        /// Segments found by one band of rows, per level.
+        struct Band
+        {
+            std::vector<std::vector<float>> x, y;
+        };
+
+        template<typename T>
+        void march_rows(const cv::Mat& g, const std::vector<double>& levels, int r0, int r1, Band& out)
+        {
+            for (int r = r0; r < r1; ++r)
+            {
+                const T* a = g.ptr<T>(r);
+                const T* b = g.ptr<T>(r + 1);
+                for (int c = 0; c + 1 < g.cols; ++c)
+                {
+                    const double v00 = a[c], v01 = a[c + 1], v10 = b[c], v11 = b[c + 1];
+                    if (!(std::isfinite(v00) && std::isfinite(v01) && std::isfinite(v10) && std::isfinite(v11))) continue;
+                    const double lo = std::min(std::min(v00, v01), std::min(v10, v11));
+                    const double hi = std::max(std::max(v00, v01), std::max(v10, v11));
+
+                    for (size_t k = 0; k < levels.size(); ++k)
+                    {
+                        const double lv = levels[k];
+                        if (lv < lo || lv > hi) continue;
+                        const int code = (v00 >= lv ? 8 : 0) | (v01 >= lv ? 4 : 0) | (v11 >= lv ? 2 : 0) | (v10 >= lv ? 1 : 0);
+                        if (code == 0 || code == 15) continue;
+
+                        auto point = [&](int edge, float& px, float& py)
+                            {
+                                switch (edge)
+                                {
+                                case 0:  px = static_cast<float>(c + (lv - v00) / (v01 - v00)); py = static_cast<float>(r); break;
+                                case 1:  px = static_cast<float>(c + 1); py = static_cast<float>(r + (lv - v01) / (v11 - v01)); break;
+                                case 2:  px = static_cast<float>(c + (lv - v10) / (v11 - v10)); py = static_cast<float>(r + 1); break;
+                                default: px = static_cast<float>(c); py = static_cast<float>(r + (lv - v00) / (v10 - v00)); break;
+                                }
+                            };
+                        auto segment = [&](int e0, int e1)
+                            {
+                                float x0, y0, x1, y1;
+                                point(e0, x0, y0);
+                                point(e1, x1, y1);
+                                out.x[k].push_back(x0); out.x[k].push_back(x1);
+                                out.y[k].push_back(y0); out.y[k].push_back(y1);
+                            };
+
+                        if (code == 5 || code == 10)
+                        {
+                            /* saddle: the cell average decides which corner pair is connected */
+                            const bool centre_high = 0.25 * (v00 + v01 + v10 + v11) >= lv;
+                            if ((code == 5) == centre_high) { segment(0, 3); segment(2, 1); }
+                            else                            { segment(0, 1); segment(3, 2); }
+                        }
+                        else
+                        {
+                            segment(kCaseEdges[code][0], kCaseEdges[code][1]);
+                        }
+                    }
+                }
+            }
+        }
+    } // namespace
+
+    ContourSegments extract_contours(const cv::Mat& grid, const std::vector<double>& levels)
+    {
+        ContourSegments out;
+        out.level_begin.assign(levels.size() + 1, 0);
+        if (grid.channels() != 1 || grid.rows < 2 || grid.cols < 2 || levels.empty()) return out;
+
+        cv::Mat g = grid;
+        if (g.depth() != CV_32F && g.depth() != CV_64F) grid.convertTo(g, CV_32F);
+
+        /* a few bands per thread balances uneven contour density */
+        const int cells = g.rows - 1;
+        const int bands = std::max(1, std::min(cells, cv::getNumThreads() * 4));
+        std::vector<Band> found(static_cast<size_t>(bands));
+        for (auto& b : found) { b.x.resize(levels.size()); b.y.resize(levels.size()); }
+
+        cv::parallel_for_(cv::Range(0, bands), [&](const cv::Range& range)
+            {
+                for (int i = range.start; i < range.end; ++i)
+                {
+                    const int r0 = static_cast<int>(static_cast<long long>(cells) * i / bands);
+                    const int r1 = static_cast<int>(static_cast<long long>(cells) * (i + 1) / bands);
+                    if (g.depth() == CV_32F) march_rows<float>(g, levels, r0, r1, found[i]);
+                    else                     march_rows<double>(g, levels, r0, r1, found[i]);
+                }
+            });
+
+        /* concatenate level by level, bands in row order */
+        size_t total = 0;
+        for (const auto& b : found)
+            for (const auto& v : b.x) total += v.size();
+        out.x.reserve(total);
+        out.y.reserve(total);
+        for (size_t k = 0; k < levels.size(); ++k)
+        {
+            out.level_begin[k] = out.size();
+            for (const auto& b : found)
+            {
+                out.x.insert(out.x.end(), b.x[k].begin(), b.x[k].end());
+                out.y.insert(out.y.end(), b.y[k].begin(), b.y[k].end());
+            }
+        }
+        out.level_begin[levels.size()] = out.size();
+        return out;
+    }
+
+} // namespace mpocv
@@ -0,0 +1,126 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+// Concurrent producers: Figure::feed(), add_stream() and the per-frame drain.
+//
+// Producers only ever touch the FigureFeed queues. Everything that mutates
+// the figure happens in drain_feeds(), on the rendering thread, before the
+// frame looks at dirty_. Each drain pops at most one ring's worth from each
+// queue, so producers that keep up with the ring cannot stall a frame.
+//
+// A stream owns the buffers of its open line command and appends each
+// frame's samples in place, past the part its Series view; only the new
+// points are added to the bounds and the pick index. The buffers are only
+// written while the stream and that command are their sole owners, so
+// copies of the command (or of the figure) never see a value change.
+
+#include "figure.h"
+#include "trace.h"
+
+#include <algorithm>
+
+namespace mpocv
+{
+    namespace
+    {
+        constexpr size_t kStreamLineMin = 1024;      ///< Capacity of a stream's first line (points).
+        constexpr size_t kStreamLineMax = 65536;     ///< Growth cap; later lines stay this size.
+
+        using StreamBuffer = std::pmr::vector<double>;
+
+        /// Fresh buffer of @p cap values from @p mr, starting with @p carry's last value (if any) and then @p v.
+        std::shared_ptr<StreamBuffer> start_buffer(const std::shared_ptr<StreamBuffer>& carry,
+            const std::vector<double>& v, size_t cap, std::pmr::memory_resource* mr)
+        {
+            auto b = std::allocate_shared<StreamBuffer>(std::pmr::polymorphic_allocator<StreamBuffer>(mr));
+            b->reserve(cap);
+            if (carry && !carry->empty()) b->push_back(carry->back());
+            b->insert(b->end(), v.begin(), v.end());
+            return b;
+        }
+    } // namespace
+
+    std::shared_ptr<FigureFeed> Figure::feed(size_t sample_capacity, size_t command_capacity)
+    {
+        if (!feed_) feed_ = std::make_shared<FigureFeed>(sample_capacity, command_capacity);
+        return feed_;
+    }
+
+    int Figure::add_stream(Color color, float thickness, const std::string& label)
+    {
+        FeedStream s;
+        s.color = color;
+        s.thickness = thickness;
+        s.label = label;
+        streams_.push_back(std::move(s));
+        return static_cast<int>(streams_.size()) - 1;
+    }
+
+    void Figure::drain_feeds()
+    {
+        for (auto& sp : subplots_) sp.drain_feeds();
+        if (!feed_) return;
+
+        MPOCV_TRACE_SCOPE("drain_feed");
+        FigureFeed& q = *feed_;
+
+        FigureFeed::Sample s;
+        for (size_t n = q.samples_.capacity(); n > 0 && q.samples_.try_pop(s); --n)
+        {
+            if (s.stream < 0 || s.stream >= static_cast<int>(streams_.size())) continue;
+            FeedStream& st = streams_[static_cast<size_t>(s.stream)];
+            st.xs.push_back(s.x);
+            st.ys.push_back(s.y);
+        }
+
+        for (FeedStream& st : streams_)
+        {
+            if (st.xs.empty()) continue;
+            const size_t k = st.xs.size();
+
+            /* the open line is gone once it was dropped, thinned, replayed over or shared by a copy */
+            const bool open = st.bx && st.line < cmds_.size() && cmds_[st.line].type == CmdType::Line
+                && cmds_[st.line].line().x.raw_data() == st.bx->data() && cmds_[st.line].line().y.raw_data() == st.by->data()
+                && st.bx.use_count() == 2 && st.by.use_count() == 2;
+
+            if (open && st.bx->size() + k <= st.bx->capacity())
+            {
+                const size_t from = st.bx->size();
+                st.bx->insert(st.bx->end(), st.xs.begin(), st.xs.end());
+                st.by->insert(st.by->end(), st.ys.begin(), st.ys.end());
+                LineData& d = cmds_[st.line].line();
+                d.x = Series(st.bx, st.bx->size());   /* same buffer and capacity: cmd_bytes_ is unchanged */
+                d.y = Series(st.by, st.by->size());
+                for (size_t i = 0; i < k; ++i) data_bounds_.expand(st.xs[i], st.ys[i]);
+                index_appended_points(st.line, from);
+                dirty_ = true;
+            }
+            else
+            {
+                /* next line: continues from the last sample, twice the capacity */
+                const size_t grown = std::clamp(st.bx ? 2 * st.bx->capacity() : 0, kStreamLineMin, kStreamLineMax);
+                const size_t cap = std::max(grown, k + 1);
+                st.bx = start_buffer(st.bx, st.xs, cap, mr_);
+                st.by = start_buffer(st.by, st.ys, cap, mr_);
+                add_line_command(Series(st.bx, st.bx->size()), Series(st.by, st.by->size()),
+                    st.color, st.thickness, st.labeled ? std::string() : st.label);
+                st.labeled = true;
+                st.line = cmds_.size() - 1;
+            }
+            st.xs.clear();
+            st.ys.clear();
+        }
+
+        FigureFeed::Command cmd;
+        for (size_t n = q.commands_.capacity(); n > 0 && q.commands_.try_pop(cmd); --n)
+        {
+            if (cmd) cmd(*this);
+        }
+    }
+
+} // namespace mpocv
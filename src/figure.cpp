@@ -7,9 +7,360 @@
 // =============================================================================
 
 #include "figure.h"
+#include "contour.h"
+#include "histogram.h"
+#include "trace.h"
+
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
 
 namespace mpocv
 {
+    namespace
+    {
+        /// Adds the lifetime of the scope (ns) to *slot; does nothing for a null slot.
+        class StageTimer
+        {
+        public:
+            explicit StageTimer(double* slot) : slot_(slot)
+            {
+                if (slot_) t0_ = std::chrono::steady_clock::now();
+            }
+            ~StageTimer()
+            {
+                if (slot_) *slot_ += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0_).count();
+            }
+            StageTimer(const StageTimer&) = delete;
+            StageTimer& operator=(const StageTimer&) = delete;
+        private:
+            double* slot_;
+            std::chrono::steady_clock::time_point t0_;
+        };
+
+        /// Canvas rectangle grown by @p pad pixels; anything fully outside is invisible.
+        cv::Rect cull_rect(const cv::Mat& canvas, int pad)
+        {
+            pad = std::max(pad, 0) + 1;
+            return { -pad, -pad, canvas.cols + 2 * pad, canvas.rows + 2 * pad };
+        }
+
+        /// Cohen-Sutherland region code of @p p relative to @p r (0 = inside).
+        int outcode(const cv::Point2i& p, const cv::Rect& r)
+        {
+            int code = 0;
+            if (p.x < r.x)                 code |= 1;
+            else if (p.x >= r.x + r.width) code |= 2;
+            if (p.y < r.y)                 code |= 4;
+            else if (p.y >= r.y + r.height) code |= 8;
+            return code;
+        }
+
+        /// Heap bytes owned by a string (0 while it fits the small-string buffer).
+        size_t string_heap(const std::pmr::string& s)
+        {
+            static const size_t sso = std::pmr::string().capacity();
+            return s.capacity() > sso ? s.capacity() + 1 : 0;
+        }
+
+        /// Heap bytes owned by a payload: its series buffers (shapes own none).
+        template<typename T>
+        size_t payload_bytes(const T&) { return 0; }
+        size_t payload_bytes(const LineData& d) { return d.x.owned_bytes() + d.y.owned_bytes(); }
+        size_t payload_bytes(const ScatterData& d)
+        {
+            return d.x.owned_bytes() + d.y.owned_bytes() + d.color_index.owned_bytes() + d.sizes.owned_bytes();
+        }
+        size_t payload_bytes(const TextData& d) { return string_heap(d.text); }
+        size_t payload_bytes(const PolygonData& d) { return d.x.owned_bytes() + d.y.owned_bytes(); }
+        size_t payload_bytes(const ImageData& d) { return d.values.owned_bytes(); }
+        size_t payload_bytes(const SegmentData& d)
+        {
+            return d.x.owned_bytes() + d.y.owned_bytes() + d.color_index.owned_bytes();
+        }
+        size_t payload_bytes(const HistData& d) { return d.data.owned_bytes(); }
+        size_t payload_bytes(const FillBetweenData& d)
+        {
+            return d.x.owned_bytes() + d.y_lo.owned_bytes() + d.y_hi.owned_bytes();
+        }
+        size_t payload_bytes(const LineMatrixData& d) { return d.x.owned_bytes() + d.y.owned_bytes(); }
+
+        /// Bytes retained by a command: the record plus the buffers it owns.
+        size_t command_bytes(const PlotCommand& c)
+        {
+            return sizeof(PlotCommand) + string_heap(c.label)
+                + std::visit([](const auto& d) { return payload_bytes(d); }, c.payload);
+        }
+
+        /// Number of points held by a series command (0 for other types).
+        size_t series_points(const PlotCommand& c)
+        {
+            switch (c.type)
+            {
+            case CmdType::Line:    return c.line().x.size();
+            case CmdType::Scatter: return c.scatter().x.size();
+            case CmdType::Polygon: return c.polygon().x.size();
+            case CmdType::Segments: return c.segments().x.size();
+            case CmdType::Histogram: return c.hist().data.size();
+            case CmdType::FillBetween: return c.band().x.size();
+            case CmdType::LineMatrix: return c.matrix().y.size();
+            default:               return 0;
+            }
+        }
+
+        /// Zero-filled byte buffer allocated from @p mr (for SampleType::UInt8 series).
+        std::shared_ptr<std::pmr::vector<unsigned char>> byte_buffer(size_t n, std::pmr::memory_resource* mr)
+        {
+            using Buffer = std::pmr::vector<unsigned char>;
+            return std::allocate_shared<Buffer>(std::pmr::polymorphic_allocator<Buffer>(mr), n);
+        }
+
+        /// Per-point inputs of a colored scatter have @p n entries each (sizes may be empty).
+        bool per_point_lengths_match(size_t n, size_t y, size_t colors, size_t sizes)
+        {
+            return y == n && colors == n && (sizes == 0 || sizes == n);
+        }
+
+        /// Keep every second sample (and the last one) in a freshly sized buffer.
+        void halve(Series& v, std::pmr::memory_resource* mr)
+        {
+            if (v.empty()) return;
+            if (v.type() == SampleType::UInt8)
+            {
+                auto out = byte_buffer((v.size() + 1) / 2 + (v.size() % 2 == 0 ? 1 : 0), mr);
+                size_t k = 0;
+                for (size_t i = 0; i < v.size(); i += 2) (*out)[k++] = static_cast<unsigned char>(v[i]);
+                if (v.size() % 2 == 0) (*out)[k++] = static_cast<unsigned char>(v.back());
+                v = Series(std::move(out));
+                return;
+            }
+            std::vector<double> out;
+            out.reserve(v.size() / 2 + 1);
+            for (size_t i = 0; i < v.size(); i += 2) out.push_back(v[i]);
+            if (v.size() % 2 == 0) out.push_back(v.back());
+            v = Series(out, mr);
+        }
+
+        /// True if a series command views external memory (e.g. a mapped file).
+        bool maps_external_data(const PlotCommand& c)
+        {
+            switch (c.type)
+            {
+            case CmdType::Line:    return c.line().x.is_view() || c.line().y.is_view();
+            case CmdType::Scatter:
+                return c.scatter().x.is_view() || c.scatter().y.is_view()
+                    || c.scatter().color_index.is_view() || c.scatter().sizes.is_view();
+            case CmdType::Polygon: return c.polygon().x.is_view() || c.polygon().y.is_view();
+            case CmdType::Histogram: return c.hist().data.is_view();
+            case CmdType::FillBetween: return c.band().x.is_view() || c.band().y_lo.is_view() || c.band().y_hi.is_view();
+            case CmdType::LineMatrix: return c.matrix().x.is_view();
+            default:               return false;
+            }
+        }
+
+        /// Halve the point count of a series command; false if there is nothing to thin.
+        /// Views are left alone: they own no bytes, so halving would only copy them into RAM.
+        bool decimate_series(PlotCommand& c, std::pmr::memory_resource* mr)
+        {
+            if (maps_external_data(c)) return false;
+            switch (c.type)
+            {
+            case CmdType::Line:
+                if (c.line().x.size() <= 2) return false;
+                halve(c.line().x, mr); halve(c.line().y, mr);
+                return true;
+            case CmdType::Scatter:
+                if (c.scatter().x.size() <= 1) return false;
+                halve(c.scatter().x, mr); halve(c.scatter().y, mr);
+                halve(c.scatter().color_index, mr); halve(c.scatter().sizes, mr);
+                return true;
+            case CmdType::Polygon:
+                if (c.polygon().x.size() <= 3) return false;
+                halve(c.polygon().x, mr); halve(c.polygon().y, mr);
+                return true;
+            case CmdType::FillBetween:
+                if (c.band().x.size() <= 2) return false;
+                halve(c.band().x, mr); halve(c.band().y_lo, mr); halve(c.band().y_hi, mr);
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        /// True if a command's extent is found on first autoscale rather than when it is added.
+        bool defers_bounds(const PlotCommand& c)
+        {
+            /* histogram extents need a binning pass, which fixed limits never require */
+            return maps_external_data(c) || c.type == CmdType::Histogram;
+        }
+
+        /// True if a command whose extent went from @p before to @p after (invalid once
+        /// dropped) may have held an edge of the overall bounds @p all.
+        bool pulls_in(const Bounds& all, const Bounds& before, const Bounds& after)
+        {
+            if (!before.valid()) return false;
+            if (!after.valid())
+                return before.xmin <= all.xmin || before.xmax >= all.xmax || before.ymin <= all.ymin || before.ymax >= all.ymax;
+            return (before.xmin <= all.xmin && after.xmin > before.xmin) || (before.xmax >= all.xmax && after.xmax < before.xmax)
+                || (before.ymin <= all.ymin && after.ymin > before.ymin) || (before.ymax >= all.ymax && after.ymax < before.ymax);
+        }
+
+        /// Primitive classes that differ in how much anti-aliasing buys.
+        enum class Prim
+        {
+            Segment,      ///< Diagonal lines and outlines of curved shapes.
+            Marker,       ///< Filled scatter / legend dots (size = radius).
+            Fill,         ///< Filled curved or slanted shapes.
+            AxisAligned,  ///< Horizontal / vertical lines and upright rectangles.
+            Text          ///< Hershey glyph strokes.
+        };
+
+        /// Cheapest OpenCV line type that still meets quality @p q for primitive @p p.
+        int line_type(RenderQuality q, Prim p, int size = 0)
+        {
+            if (q == RenderQuality::Draft || p == Prim::AxisAligned) return cv::LINE_8;
+            if (q == RenderQuality::Final) return cv::LINE_AA;
+            /* Normal: markers of a pixel or two look the same without AA */
+            return (p == Prim::Marker && size < 2) ? cv::LINE_8 : cv::LINE_AA;
+        }
+
+        /// @p r enlarged by @p m pixels on every side (room for AA fringes and strokes).
+        cv::Rect grow(const cv::Rect& r, int m)
+        {
+            return { r.x - m, r.y - m, r.width + 2 * m + 1, r.height + 2 * m + 1 };
+        }
+
+        /// Case-insensitive check of a file name suffix such as ".svg".
+        bool has_extension(const std::string& filename, const char* ext)
+        {
+            const size_t n = std::strlen(ext);
+            if (filename.size() < n) return false;
+            for (size_t i = 0; i < n; ++i)
+            {
+                const char c = filename[filename.size() - n + i];
+                if (std::tolower(static_cast<unsigned char>(c)) != ext[i]) return false;
+            }
+            return true;
+        }
+
+        /// Finite range of @p values for colormapping; a flat or empty range is widened to one unit.
+        template<typename Values>
+        void finite_range(const Values& values, double& vmin, double& vmax)
+        {
+            vmin = std::numeric_limits<double>::infinity();
+            vmax = -vmin;
+            for (size_t i = 0; i < values.size(); ++i)
+            {
+                const double v = values[i];
+                if (std::isfinite(v)) { vmin = std::min(vmin, v); vmax = std::max(vmax, v); }
+            }
+            if (!(vmin < vmax)) { vmin = std::isfinite(vmin) ? vmin - 0.5 : 0.0; vmax = vmin + 1.0; }
+        }
+
+        /// imwrite / imencode flags for the settings in @p p that apply to the encoder of @p ext.
+        std::vector<int> encode_flags(const std::string& ext, const EncodeParams& p)
+        {
+            std::vector<int> flags;
+            if (has_extension(ext, ".png"))
+            {
+                if (p.png_compression >= 0) flags.insert(flags.end(), { cv::IMWRITE_PNG_COMPRESSION, std::min(p.png_compression, 9) });
+            }
+            else if (has_extension(ext, ".jpg") || has_extension(ext, ".jpeg"))
+            {
+                if (p.jpeg_quality >= 0) flags.insert(flags.end(), { cv::IMWRITE_JPEG_QUALITY, std::min(p.jpeg_quality, 100) });
+                if (p.jpeg_progressive) flags.insert(flags.end(), { cv::IMWRITE_JPEG_PROGRESSIVE, 1 });
+                if (p.jpeg_optimize) flags.insert(flags.end(), { cv::IMWRITE_JPEG_OPTIMIZE, 1 });
+            }
+            else if (has_extension(ext, ".webp"))
+            {
+                if (p.webp_quality >= 0) flags.insert(flags.end(), { cv::IMWRITE_WEBP_QUALITY, std::max(p.webp_quality, 1) });
+            }
+            return flags;
+        }
+
+        /// OpenCV Mat type of a canvas format.
+        int canvas_type(CanvasFormat f)
+        {
+            switch (f)
+            {
+            case CanvasFormat::GRAY8: return CV_8UC1;
+            case CanvasFormat::BGRA8: return CV_8UC4;
+            case CanvasFormat::BGR16: return CV_16UC3;
+            default:                  return CV_8UC3;
+            }
+        }
+
+        /// @p c as drawn into a canvas of format @p f (alpha is used by BGRA8 only).
+        cv::Scalar format_scalar(CanvasFormat f, const Color& c, double alpha = 1.0)
+        {
+            switch (f)
+            {
+            case CanvasFormat::GRAY8: return cv::Scalar((299 * c.r + 587 * c.g + 114 * c.b + 500) / 1000);
+            case CanvasFormat::BGRA8: return cv::Scalar(c.b, c.g, c.r, static_cast<uchar>(alpha * 255));
+            case CanvasFormat::BGR16: return cv::Scalar(c.b * 257.0, c.g * 257.0, c.r * 257.0);
+            default:                  return cv::Scalar(c.b, c.g, c.r);
+            }
+        }
+
+        /// Converts 8-bit BGR pixels (colorized images) to format @p f in place.
+        void bgr_to_format(cv::Mat& bgr, CanvasFormat f)
+        {
+            switch (f)
+            {
+            case CanvasFormat::GRAY8: cv::cvtColor(bgr, bgr, cv::COLOR_BGR2GRAY); break;
+            case CanvasFormat::BGRA8: cv::cvtColor(bgr, bgr, cv::COLOR_BGR2BGRA); break;
+            case CanvasFormat::BGR16: bgr.convertTo(bgr, CV_16U, 257.0); break;
+            default: break;
+            }
+        }
+
+        /// Colormap colors in format @p f, for per-item colors in draw loops.
+        void scalar_lut(Colormap cmap, CanvasFormat f, cv::Scalar (&lut)[256])
+        {
+            const Color* cm = colormap_lut(cmap);
+            for (int k = 0; k < 256; ++k) lut[k] = format_scalar(f, cm[k]);
+        }
+
+        /// Float samples copied into a byte buffer from @p mr (SampleType::Float32 series).
+        Series float_series(const std::vector<float>& v, std::pmr::memory_resource* mr)
+        {
+            auto bytes = byte_buffer(v.size() * sizeof(float), mr);
+            if (!v.empty()) std::memcpy(bytes->data(), v.data(), v.size() * sizeof(float));
+            return Series(std::move(bytes), SampleType::Float32);
+        }
+
+        /// True if @p a and @p b map data to the same pixels.
+        bool same_limits(const Axes& a, const Axes& b)
+        {
+            return a.xmin == b.xmin && a.xmax == b.xmax && a.ymin == b.ymin && a.ymax == b.ymax;
+        }
+
+        /// Header over an image command's samples (no copy unless they are strided).
+        cv::Mat image_source(const ImageData& d)
+        {
+            const Series& v = d.values;
+            const int depth = v.type() == SampleType::Float64 ? CV_64F : v.type() == SampleType::Float32 ? CV_32F : CV_8U;
+            if (v.stride() == Series::sample_size(v.type()))
+                return cv::Mat(d.rows, d.cols, CV_MAKETYPE(depth, 1), const_cast<void*>(v.raw_data()));
+            cv::Mat m(d.rows, d.cols, CV_64FC1);
+            for (size_t i = 0; i < v.size(); ++i) m.at<double>(static_cast<int>(i)) = v[i];
+            return m;
+        }
+
+        /// Clamp a pixel coordinate to a range that converts to int safely.
+        double clamp_px(double v)
+        {
+            return std::min(std::max(v, -1e8), 1e8);
+        }
+
+        /// Number of OpenCV draw calls a shape with this style issues.
+        size_t shape_primitives(const ShapeStyle& s)
+        {
+            return (s.fill_alpha > 0.0f ? 1u : 0u) + (s.thickness > 0.0f ? 1u : 0u);
+        }
+    } // namespace
 
     /* --------------------------------------------------------------------------
      *  Public?facing API
@@ -18,9 +369,16 @@ namespace mpocv
      // ---------------------------------------------------------------------------
      // Construction & basic settings
      // ---------------------------------------------------------------------------
-    Figure::Figure(int w, int h)
-        : width_(w), height_(h),
-        canvas_(h, w, CV_8UC3, cv::Scalar(255, 255, 255))
+    Figure::Figure(int w, int h, std::pmr::memory_resource* mr)
+        : mr_(mr), width_(w), height_(h),
+        canvas_(h, w, CV_8UC3, cv::Scalar(255, 255, 255)),
+        cmds_(mr)
+    {}
+
+    Figure::Figure(const cv::Mat& roi, std::pmr::memory_resource* mr)
+        : mr_(mr), width_(roi.cols), height_(roi.rows),
+        canvas_(roi),
+        cmds_(mr)
     {}
 
     void Figure::set_xlim(double lo, double hi)
@@ -50,6 +408,28 @@ namespace mpocv
         legend_on_ = on; legend_loc_ = loc; dirty_ = true;
     }
 
+    // ---------------------------------------------------------------------------
+    // Subplots
+    // ---------------------------------------------------------------------------
+    Figure& Figure::subplot(int rows, int cols, int index)
+    {
+        rows = std::max(1, rows);
+        cols = std::max(1, cols);
+        if (rows != sub_rows_ || cols != sub_cols_)
+        {
+            sub_rows_ = rows; sub_cols_ = cols;
+            subplots_.clear();
+            subplots_.reserve(static_cast<size_t>(rows) * cols);
+            for (int i = 0; i < rows * cols; ++i) subplots_.push_back(Figure(cv::Mat(), mr_));
+            for (auto& sp : subplots_) sp.quality_ = quality_;
+            for (auto& sp : subplots_) sp.format_ = format_;
+            layout_subplots();
+            dirty_ = true;
+        }
+        index = std::min(std::max(index, 1), rows * cols);
+        return subplots_[index - 1];
+    }
+
     // ---------------------------------------------------------------------------
     // Plot primitives (thin wrappers that delegate to helpers)
     // ---------------------------------------------------------------------------
@@ -64,6 +444,12 @@ namespace mpocv
         add_line_command(std::move(x), std::move(y), c, thickness, label);
     }
 
+    void Figure::plot(const Series& x, const Series& y,
+        Color c, float thickness, const std::string& label)
+    {
+        add_line_command(x, y, c, thickness, label);
+    }
+
     void Figure::scatter(const std::vector<double>& x, const std::vector<double>& y,
         Color c, float marker_size, const std::string& label)
     {
@@ -74,73 +460,271 @@ namespace mpocv
     {
         add_scatter_command(std::move(x), std::move(y), c, marker_size, label);
     }
+    void Figure::scatter(const Series& x, const Series& y,
+        Color c, float marker_size, const std::string& label)
+    {
+        add_scatter_command(x, y, c, marker_size, label);
+    }
+
+    void Figure::scatter_colored(const std::vector<double>& x, const std::vector<double>& y,
+        const std::vector<double>& values, const std::vector<double>& sizes,
+        Colormap cmap, double vmin, double vmax, const std::string& label)
+    {
+        if (!per_point_lengths_match(x.size(), y.size(), values.size(), sizes.size())) return;
+        if (!(vmin < vmax)) finite_range(values, vmin, vmax);
+        auto idx = byte_buffer(values.size(), mr_);
+        const double scale = 255.0 / (vmax - vmin);
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            const double t = (values[i] - vmin) * scale;
+            (*idx)[i] = static_cast<unsigned char>(t > 0.0 ? (t < 255.0 ? t + 0.5 : 255.0) : 0.0);   /* NaN -> 0 */
+        }
+        add_scatter_indexed(x, y, Series(std::move(idx)), sizes, cmap, label);
+    }
+
+    void Figure::scatter_classes(const std::vector<double>& x, const std::vector<double>& y,
+        const std::vector<int>& classes, const std::vector<double>& sizes,
+        Colormap cmap, const std::string& label)
+    {
+        if (!per_point_lengths_match(x.size(), y.size(), classes.size(), sizes.size())) return;
+        auto idx = byte_buffer(classes.size(), mr_);
+        for (size_t i = 0; i < classes.size(); ++i) (*idx)[i] = static_cast<unsigned char>(classes[i] & 255);
+        add_scatter_indexed(x, y, Series(std::move(idx)), sizes, cmap, label);
+    }
+
+    void Figure::add_scatter_indexed(const std::vector<double>& x, const std::vector<double>& y,
+        Series&& index, const std::vector<double>& sizes, Colormap cmap, const std::string& label)
+    {
+        if (!per_point_lengths_match(x.size(), y.size(), index.size(), sizes.size())) return;
+        PlotCommand cmd(CmdType::Scatter, mr_);
+        cmd.color = colormap_lut(cmap)[cmap == Colormap::Tab10 ? 0 : 128];   /* legend swatch */
+        cmd.label = label;
+        cmd.scatter().x = make_series(x);
+        cmd.scatter().y = make_series(y);
+        cmd.scatter().color_index = std::move(index);
+        if (!sizes.empty()) cmd.scatter().sizes = make_series(sizes);
+        cmd.scatter().cmap = cmap;
+        push_command(std::move(cmd));
+    }
+
+    void Figure::image(const cv::Mat& values, double x0, double y0, double x1, double y1,
+        Colormap cmap, double vmin, double vmax, ImageInterp interp, const std::string& label)
+    {
+        if (values.empty() || values.channels() != 1) return;
+
+        /* one copy into mr_, keeping 8-bit / float / double samples as they are */
+        cv::Mat src;
+        if (values.depth() == CV_8U || values.depth() == CV_32F || values.depth() == CV_64F) src = values;
+        else values.convertTo(src, CV_32F);
+        const SampleType type = src.depth() == CV_8U ? SampleType::UInt8
+            : src.depth() == CV_32F ? SampleType::Float32 : SampleType::Float64;
+        const size_t row_bytes = static_cast<size_t>(src.cols) * src.elemSize();
+        auto bytes = byte_buffer(row_bytes * src.rows, mr_);
+        for (int r = 0; r < src.rows; ++r) std::memcpy(bytes->data() + r * row_bytes, src.ptr(r), row_bytes);
+
+        PlotCommand cmd(CmdType::Image, mr_);
+        cmd.label = label;
+        ImageData& d = cmd.image();
+        d.values = Series(std::move(bytes), type);
+        d.rows = src.rows; d.cols = src.cols;
+        d.x0 = std::min(x0, x1); d.x1 = std::max(x0, x1);
+        d.y0 = std::min(y0, y1); d.y1 = std::max(y0, y1);
+        if (!(vmin < vmax)) finite_range(d.values, vmin, vmax);
+        d.vmin = vmin; d.vmax = vmax;
+        d.cmap = cmap;
+        d.interp = interp;
+        d.id = new_cache_id();
+        cmd.color = colormap_lut(cmap)[128];   /* legend swatch */
+        push_command(std::move(cmd));
+    }
+
+    void Figure::image(const cv::Mat& values, Colormap cmap, double vmin, double vmax,
+        ImageInterp interp, const std::string& label)
+    {
+        image(values, 0.0, 0.0, values.cols, values.rows, cmap, vmin, vmax, interp, label);
+    }
+
+    void Figure::contour(const cv::Mat& grid, const std::vector<double>& levels,
+        double x0, double y0, double x1, double y1,
+        Colormap cmap, float thickness, const std::string& label)
+    {
+        if (grid.empty() || grid.channels() != 1 || levels.empty()) return;
+        ContourSegments segs;
+        {
+            MPOCV_TRACE_SCOPE("extract_contours");
+            segs = extract_contours(grid, levels);
+        }
+
+        PlotCommand cmd(CmdType::Segments, mr_);
+        cmd.label = label;
+        SegmentData& d = cmd.segments();
+        d.x = float_series(segs.x, mr_);
+        d.y = float_series(segs.y, mr_);
+
+        /* grid (c, r) -> centre of cell (r, c) of the extent; row 0 at the top */
+        const double w = (std::max(x0, x1) - std::min(x0, x1)) / grid.cols;
+        const double h = (std::max(y0, y1) - std::min(y0, y1)) / grid.rows;
+        d.ox = std::min(x0, x1) + 0.5 * w;  d.sx = w;
+        d.oy = std::max(y0, y1) - 0.5 * h;  d.sy = -h;
+        d.thickness = thickness;
+        d.cmap = cmap;
+
+        const Color* lut = colormap_lut(cmap);
+        const size_t n = levels.size();
+        if (n > 1)
+        {
+            auto idx = byte_buffer(segs.size(), mr_);
+            for (size_t k = 0; k < n; ++k)
+            {
+                const unsigned char v = static_cast<unsigned char>((k * 255 + (n - 1) / 2) / (n - 1));
+                std::fill(idx->begin() + segs.level_begin[k], idx->begin() + segs.level_begin[k + 1], v);
+            }
+            d.color_index = Series(std::move(idx));
+            cmd.color = lut[128];   /* legend swatch */
+        }
+        else
+        {
+            cmd.color = lut[0];
+        }
+        push_command(std::move(cmd));
+    }
+
+    void Figure::contour(const cv::Mat& grid, const std::vector<double>& levels,
+        Colormap cmap, float thickness, const std::string& label)
+    {
+        contour(grid, levels, 0.0, 0.0, grid.cols, grid.rows, cmap, thickness, label);
+    }
+
+    void Figure::hist(const std::vector<double>& data, int bins, const ShapeStyle& style, const std::string& label)
+    {
+        hist(make_series(data), bins, style, label);
+    }
+
+    void Figure::hist(std::vector<double>&& data, int bins, const ShapeStyle& style, const std::string& label)
+    {
+        hist(make_series(std::move(data)), bins, style, label);
+    }
+
+    void Figure::hist(const Series& data, int bins, const ShapeStyle& style, const std::string& label)
+    {
+        if (data.empty() || bins < 1) return;
+
+        PlotCommand cmd(CmdType::Histogram, mr_);
+        cmd.color = style.fill_color;   /* legend swatch */
+        cmd.label = label;
+        cmd.hist().data = data;
+        cmd.hist().bins = bins;
+        cmd.hist().style = style;
+        cmd.hist().id = new_cache_id();
+        push_command(std::move(cmd));
+    }
+
+    void Figure::plot_matrix(const std::vector<double>& x, const cv::Mat& Y,
+        Colormap cmap, float thickness, const std::string& label)
+    {
+        if (x.size() < 2 || (Y.cols != static_cast<int>(x.size()) && Y.rows != static_cast<int>(x.size()))) return;
+        plot_matrix(make_series(x), Y, cmap, thickness, label);
+    }
+
+    void Figure::plot_matrix(const Series& x, const cv::Mat& Y,
+        Colormap cmap, float thickness, const std::string& label)
+    {
+        if (Y.empty() || Y.channels() != 1 || x.size() < 2) return;
+
+        /* channel-major: rows are series unless only the columns match x */
+        cv::Mat src = Y;
+        if (Y.cols != static_cast<int>(x.size()))
+        {
+            if (Y.rows != static_cast<int>(x.size())) return;
+            cv::transpose(Y, src);
+        }
+        if (src.depth() != CV_8U && src.depth() != CV_32F && src.depth() != CV_64F) src.convertTo(src, CV_32F);
+        const SampleType type = src.depth() == CV_8U ? SampleType::UInt8
+            : src.depth() == CV_32F ? SampleType::Float32 : SampleType::Float64;
+        const size_t row_bytes = static_cast<size_t>(src.cols) * src.elemSize();
+        auto bytes = byte_buffer(row_bytes * src.rows, mr_);
+        for (int r = 0; r < src.rows; ++r) std::memcpy(bytes->data() + r * row_bytes, src.ptr(r), row_bytes);
+
+        PlotCommand cmd(CmdType::LineMatrix, mr_);
+        cmd.label = label;
+        LineMatrixData& d = cmd.matrix();
+        d.x = x;
+        d.y = Series(std::move(bytes), type);
+        d.channels = src.rows;
+        d.thickness = thickness;
+        d.cmap = cmap;
+        cmd.color = d.channel_color(0);   /* legend swatch */
+        push_command(std::move(cmd));
+    }
+
+    void Figure::fill_between(const std::vector<double>& x, const std::vector<double>& y_lo,
+        const std::vector<double>& y_hi, const ShapeStyle& style, const std::string& label)
+    {
+        if (x.size() != y_lo.size() || x.size() != y_hi.size() || x.size() < 2) return;
+        fill_between(make_series(x), make_series(y_lo), make_series(y_hi), style, label);
+    }
+
+    void Figure::fill_between(const Series& x, const Series& y_lo, const Series& y_hi,
+        const ShapeStyle& style, const std::string& label)
+    {
+        if (x.size() != y_lo.size() || x.size() != y_hi.size() || x.size() < 2) return;
+
+        PlotCommand cmd(CmdType::FillBetween, mr_);
+        cmd.color = style.fill_color;   /* legend swatch */
+        cmd.label = label;
+        cmd.band() = { x, y_lo, y_hi, style };
+        push_command(std::move(cmd));
+    }
 
     void Figure::text(double x, double y, const std::string& msg, Color c,
         double font_scale, int thickness,
         TextData::HAlign ha, TextData::VAlign va,
         const std::string& label)
     {
-        PlotCommand cmd;
-        cmd.type = CmdType::Text;
+        PlotCommand cmd(CmdType::Text, mr_);
         cmd.color = c;
         cmd.label = label;
-        cmd.txt = { x, y, msg, font_scale, thickness, ha, va };
-        cmds_.push_back(std::move(cmd));
-        dirty_ = true;
+        cmd.txt().x = x; cmd.txt().y = y;
+        cmd.txt().text = msg;
+        cmd.txt().font_scale = font_scale; cmd.txt().thickness = thickness;
+        cmd.txt().halign = ha; cmd.txt().valign = va;
+        push_command(std::move(cmd));
     }
 
     void Figure::circle(double cx, double cy, double radius,
         const ShapeStyle& style, const std::string& label)
     {
-        PlotCommand cmd;
-        cmd.type = CmdType::Circle;
-        cmd.circle = { cx, cy, radius, style };
+        PlotCommand cmd(CmdType::Circle, mr_);
+        cmd.circle() = { cx, cy, radius, style };
         cmd.label = label;
-        data_bounds_.expand(cx - radius, cy - radius);
-        data_bounds_.expand(cx + radius, cy + radius);
-        cmds_.push_back(std::move(cmd));
-        dirty_ = true;
+        push_command(std::move(cmd));
     }
 
     void Figure::rect_xywh(double x, double y, double w, double h,
         const ShapeStyle& style, const std::string& label)
     {
-        PlotCommand cmd;
-        cmd.type = CmdType::RectXYWH;
-        cmd.rect = { x, y, x + w, y + h, style };
+        PlotCommand cmd(CmdType::RectXYWH, mr_);
+        cmd.rect() = { x, y, x + w, y + h, style };
         cmd.label = label;
-        data_bounds_.expand(x, y);
-        data_bounds_.expand(x + w, y + h);
-        cmds_.push_back(std::move(cmd));
-        dirty_ = true;
+        push_command(std::move(cmd));
     }
 
     void Figure::rect_ltrb(double x0, double y0, double x1, double y1,
         const ShapeStyle& style, const std::string& label)
     {
-        PlotCommand cmd;
-        cmd.type = CmdType::RectLTRB;
-        cmd.rect = { x0, y0, x1, y1, style };
+        PlotCommand cmd(CmdType::RectLTRB, mr_);
+        cmd.rect() = { x0, y0, x1, y1, style };
         cmd.label = label;
-        data_bounds_.expand(x0, y0);
-        data_bounds_.expand(x1, y1);
-        cmds_.push_back(std::move(cmd));
-        dirty_ = true;
+        push_command(std::move(cmd));
     }
 
     void Figure::rotated_rect(double cx, double cy, double w, double h, double angle_deg,
         const ShapeStyle& style, const std::string& label)
     {
-        PlotCommand cmd;
-        cmd.type = CmdType::RotatedRect;
-        cmd.rot_rect = { cx, cy, w, h, angle_deg, style };
+        PlotCommand cmd(CmdType::RotatedRect, mr_);
+        cmd.rot_rect() = { cx, cy, w, h, angle_deg, style };
         cmd.label = label;
-
-        const double r = 0.5 * std::sqrt(w * w + h * h);
-        data_bounds_.expand(cx - r, cy - r);
-        data_bounds_.expand(cx + r, cy + r);
-        cmds_.push_back(std::move(cmd));
-        dirty_ = true;
+        push_command(std::move(cmd));
     }
 
     void Figure::polygon(const std::vector<double>& x, const std::vector<double>& y,
@@ -148,41 +732,604 @@ namespace mpocv
     {
         if (x.size() != y.size() || x.empty()) return;
 
-        PlotCommand cmd;
-        cmd.type = CmdType::Polygon;
-        cmd.polygon = { x, y, style };
-        cmd.label = label;
+        PlotCommand cmd(CmdType::Polygon, mr_);
+        cmd.polygon() = { make_series(x), make_series(y), style };
+        cmd.label = label;
+        push_command(std::move(cmd));
+    }
+
+    void Figure::ellipse(double cx, double cy, double w, double h, double angle_deg,
+        const ShapeStyle& style, const std::string& label)
+    {
+        PlotCommand cmd(CmdType::Ellipse, mr_);
+        cmd.ellipse() = { cx, cy, w, h, angle_deg, style };
+        cmd.label = label;
+        push_command(std::move(cmd));
+    }
+
+    // ---------------------------------------------------------------------------
+    // Memory accounting
+    // ---------------------------------------------------------------------------
+    MemoryUsage Figure::memory_usage() const
+    {
+        MemoryUsage mu;
+        add_memory_usage(mu, -1);
+        mu.canvas = canvas_.total() * canvas_.elemSize();
+        for (const auto& f : frames_) mu.canvas += f.total() * f.elemSize();
+        for (size_t i = 0; i < subplots_.size(); ++i)
+            subplots_[i].add_memory_usage(mu, static_cast<int>(i));
+        return mu;
+    }
+
+    void Figure::memory_budget(size_t bytes, MemoryPolicy policy)
+    {
+        mem_budget_ = bytes;
+        mem_policy_ = policy;
+        if (policy != MemoryPolicy::Throw) enforce_budget(0);
+        for (auto& sp : subplots_) sp.memory_budget(bytes, policy);
+    }
+
+    void Figure::add_memory_usage(MemoryUsage& mu, int subplot) const
+    {
+        for (size_t i = 0; i < cmds_.size(); ++i)
+        {
+            const PlotCommand& c = cmds_[i];
+            const size_t bytes = command_bytes(c);
+            mu.per_type[static_cast<size_t>(c.type)] += bytes;
+            const size_t n = series_points(c);
+            if (n > 0) mu.series.push_back({ subplot, i, c.type, std::string(c.label.data(), c.label.size()), n, bytes });
+        }
+        mu.command_slack += (cmds_.capacity() - cmds_.size()) * sizeof(PlotCommand);
+        mu.caches += ylabel_cache_.total() * ylabel_cache_.elemSize()
+            + blend_scratch_.total() * blend_scratch_.elemSize()
+            + encode_scratch_.total() * encode_scratch_.elemSize()
+            + band_scratch_.capacity() * sizeof(PixelPoint) + band_px_.capacity() * sizeof(cv::Point)
+            + matrix_px_.capacity() * sizeof(int) + matrix_pts_.capacity() * sizeof(cv::Point)
+            + prog_.back.total() * prog_.back.elemSize();
+        for (const auto& e : image_cache_) mu.caches += e.bgr.total() * e.bgr.elemSize();
+        for (const auto& e : hist_cache_) mu.caches += e.counts.capacity() * sizeof(uint64_t);
+        mu.caches += pick_grid_.memory_bytes() + pick_shapes_.capacity() * sizeof(PickShape);
+    }
+
+    void Figure::push_command(PlotCommand&& cmd)
+    {
+        const size_t bytes = command_bytes(cmd);
+        enforce_budget(bytes);
+        cmds_.push_back(std::move(cmd));
+        cmd_bytes_ += bytes;
+        if (!defers_bounds(cmds_.back()))
+            expand_bounds(cmds_.back());
+        else if (bounds_pending_from_ == kNoPendingBounds)
+            bounds_pending_from_ = cmds_.size() - 1;   /* scanned on first autoscale, see update_limits() */
+        dirty_ = true;
+    }
+
+    void Figure::adopt_command(PlotCommand&& cmd)
+    {
+        cmd_bytes_ += command_bytes(cmd);
+        cmds_.push_back(std::move(cmd));
+        dirty_ = true;
+    }
+
+    void Figure::enforce_budget(size_t incoming)
+    {
+        if (mem_budget_ == 0 || cmd_bytes_ + incoming <= mem_budget_) return;
+
+        /* commands past bounds_pending_from_ are not in data_bounds_ yet; the others only
+           invalidate it when they held one of its edges */
+        bool shrink_bounds = false;
+        const auto in_bounds = [this](size_t i) { return bounds_pending_from_ == kNoPendingBounds || i < bounds_pending_from_; };
+        bool reindex = false;
+        size_t dropped = 0;
+
+        switch (mem_policy_)
+        {
+        case MemoryPolicy::Throw:
+            throw std::length_error("mpocv::Figure: command memory budget exceeded");
+
+        case MemoryPolicy::DecimateOldest:
+            /* sweep from the oldest command, halving series until the new one fits;
+               repeated sweeps keep thinning the oldest data the most */
+            for (bool progress = true; progress && cmd_bytes_ + incoming > mem_budget_;)
+            {
+                progress = false;
+                for (size_t i = 0; i < cmds_.size(); ++i)
+                {
+                    if (cmd_bytes_ + incoming <= mem_budget_) break;
+                    PlotCommand& c = cmds_[i];
+                    const size_t before = command_bytes(c);
+                    const Bounds box = in_bounds(i) && !shrink_bounds ? command_box(c) : Bounds{};
+                    if (!decimate_series(c, mr_)) continue;
+                    cmd_bytes_ = cmd_bytes_ - before + command_bytes(c);
+                    if (box.valid() && pulls_in(data_bounds_, box, command_box(c))) shrink_bounds = true;
+                    reindex = reindex || i < pick_indexed_;   /* sample indices moved */
+                    progress = true;
+                }
+            }
+            if (cmd_bytes_ + incoming <= mem_budget_) break;
+            [[fallthrough]];   /* nothing left to thin: drop instead */
+
+        case MemoryPolicy::DropOldest:
+        {
+            while (dropped < cmds_.size() && cmd_bytes_ + incoming > mem_budget_)
+            {
+                const PlotCommand& c = cmds_[dropped];
+                cmd_bytes_ -= command_bytes(c);
+                /* a mapped view is not rescanned just to find out */
+                if (!shrink_bounds && in_bounds(dropped))
+                    shrink_bounds = defers_bounds(c) || pulls_in(data_bounds_, command_box(c), Bounds{});
+                ++dropped;
+            }
+            cmds_.erase(cmds_.begin(), cmds_.begin() + static_cast<std::ptrdiff_t>(dropped));
+            for (FeedStream& st : streams_)
+                st.line = st.line >= dropped ? st.line - dropped : cmds_.size();   /* open line dropped */
+            break;
+        }
+        }
+
+        /* bounds are rebuilt on the next autoscale, not on every push */
+        if (shrink_bounds)
+        {
+            data_bounds_ = Bounds{};
+            bounds_pending_from_ = 0;
+        }
+        else if (bounds_pending_from_ != kNoPendingBounds)
+            bounds_pending_from_ = bounds_pending_from_ > dropped ? bounds_pending_from_ - dropped : 0;
+
+        if (reindex) reset_pick_index();
+        else         drop_from_pick_index(dropped);
+        dirty_ = true;
+    }
+
+    // ---------------------------------------------------------------------------
+    // Rendering & I/O
+    // ---------------------------------------------------------------------------
+    void Figure::render()
+    {
+        render_canvas();
+        publish_frame();
+    }
+
+    void Figure::publish_frame()
+    {
+        publish_shm_frame();
+        publish_mjpeg();
+    }
+
+    void Figure::render_canvas()
+    {
+        drain_feeds();
+        if (!subplots_.empty()) { render_subplots(); return; }
+        if (!dirty_)
+        {
+            if (prog_.active) render_progressive(std::numeric_limits<double>::infinity());
+            return;
+        }
+        prog_.active = false;
+
+        MPOCV_TRACE_SCOPE("render");
+        if (stats_on_) stats_.reset();
+        StageTimer total(stats_on_ ? &stats_.total_ns : nullptr);
+
+        /* 1) autoscale, padding, equal-scale ----------------------------------- */
+        {
+            StageTimer t(stage_slot(RenderStage::Autoscale));
+            MPOCV_TRACE_SCOPE("autoscale");
+            update_limits();
+        }
+
+        /* 2) ticks ------------------------------------------------------------- */
+        TickInfo xt, yt;
+        {
+            StageTimer t(stage_slot(RenderStage::Ticks));
+            MPOCV_TRACE_SCOPE("make_ticks");
+            xt = make_ticks(axes_.xmin, axes_.xmax);
+            yt = make_ticks(axes_.ymin, axes_.ymax);
+        }
+
+        /* 3) clear canvas ------------------------------------------------------ */
+        {
+            StageTimer t(stage_slot(RenderStage::Clear));
+            MPOCV_TRACE_SCOPE("clear");
+            canvas_.setTo(background());
+        }
+
+        /* 4) grid & axes ------------------------------------------------------- */
+        {
+            StageTimer t(stage_slot(RenderStage::Grid));
+            MPOCV_TRACE_SCOPE("draw_grid");
+            draw_grid(xt, yt);
+        }
+        {
+            StageTimer t(stage_slot(RenderStage::Axes));
+            MPOCV_TRACE_SCOPE("draw_axes");
+            draw_axes(xt, yt);
+        }
+
+        /* 5) retained commands ------------------------------------------------- */
+        {
+            StageTimer t(stage_slot(RenderStage::Commands));
+            MPOCV_TRACE_SCOPE("commands");
+            for (const auto& cmd : cmds_)
+            {
+                const size_t ti = static_cast<size_t>(cmd.type);
+                StageTimer ct(stats_on_ ? &stats_.cmd_ns[ti] : nullptr);
+                draw_command(cmd);
+                ++stats_.cmd_count[ti];
+            }
+        }
+
+        /* 6) legend ------------------------------------------------------------ */
+        {
+            StageTimer t(stage_slot(RenderStage::Legend));
+            MPOCV_TRACE_SCOPE("legend");
+            draw_legend();
+        }
+
+        /* 7) title & labels ---------------------------------------------------- */
+        {
+            StageTimer t(stage_slot(RenderStage::Labels));
+            MPOCV_TRACE_SCOPE("labels");
+            draw_labels();
+        }
+
+        dirty_ = false;
+        drawn_quality_ = quality_;
+        ++frame_seq_;
+    }
+
+    RenderProgress Figure::render_progressive(double budget_ms)
+    {
+        if (!subplots_.empty())
+        {
+            render();
+            return RenderProgress{};
+        }
+        drain_feeds();
+
+        using Clock = std::chrono::steady_clock;
+        const auto deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double, std::milli>(std::min(budget_ms, 1e9)));
+
+        if (dirty_)
+        {
+            MPOCV_TRACE_SCOPE("progressive_start");
+            update_limits();
+            prog_.xt = make_ticks(axes_.xmin, axes_.xmax);
+            prog_.yt = make_ticks(axes_.ymin, axes_.ymax);
+
+            /* coarsest pass draws at most about kCoarsePoints samples */
+            size_t stride = 1;
+            while (pass_work(stride) > kCoarsePoints && stride < (size_t(1) << 40)) stride *= 2;
+
+            RenderProgress& info = prog_.info;
+            info = RenderProgress{};
+            info.stride = stride;
+            info.complete = false;
+            for (size_t s = stride; ; s /= 2)
+            {
+                info.work_total += pass_work(s);
+                ++info.passes;
+                if (s == 1) break;
+            }
+            if (prog_.back.size() != canvas_.size() || prog_.back.type() != canvas_.type())
+                prog_.back.create(canvas_.size(), canvas_.type());
+
+            std::swap(canvas_, prog_.back);
+            begin_pass();
+            std::swap(canvas_, prog_.back);
+            prog_.active = true;
+            dirty_ = false;
+            drawn_quality_ = quality_;
+        }
+        if (!prog_.active) return prog_.info;
+
+        MPOCV_TRACE_SCOPE("progressive_step");
+        RenderProgress& info = prog_.info;
+        std::swap(canvas_, prog_.back);   /* draw off-screen */
+        bool on_screen = false;
+        do
+        {
+            if (prog_.cmd < cmds_.size())
+            {
+                const PlotCommand& cmd = cmds_[prog_.cmd];
+                if (cmd.type == CmdType::Line || cmd.type == CmdType::Scatter)
+                {
+                    const size_t next = draw_series_chunk(cmd, prog_.pos, info.stride, kProgressChunk);
+                    const size_t n = series_points(cmd);
+                    const size_t before = prog_.pos;
+                    prog_.pos = next;
+                    info.work_done += (std::min(next, n) - before + info.stride - 1) / info.stride;
+                    if (next >= n) { ++prog_.cmd; prog_.pos = 0; }
+                }
+                else
+                {
+                    draw_command(cmd);
+                    ++info.work_done;
+                    ++prog_.cmd;
+                }
+                continue;
+            }
+
+            /* pass complete: overlay legend and labels; it stays on canvas_ */
+            draw_legend();
+            draw_labels();
+            ++info.pass;
+            ++frame_seq_;
+            if (info.stride == 1)
+            {
+                info.complete = true;
+                info.work_done = info.work_total;
+                prog_.active = false;
+                on_screen = true;
+                break;
+            }
+            info.stride /= 2;
+            prog_.cmd = 0;
+            prog_.pos = 0;
+            std::swap(canvas_, prog_.back);   /* next pass reuses the previous front buffer */
+            begin_pass();
+        } while (Clock::now() < deadline);
+
+        if (!on_screen) std::swap(canvas_, prog_.back);
+        publish_frame();
+        return info;
+    }
+
+    size_t Figure::pass_work(size_t stride) const
+    {
+        size_t work = 0;
+        for (const auto& c : cmds_)
+        {
+            if (c.type == CmdType::Line || c.type == CmdType::Scatter)
+                work += (series_points(c) + stride - 1) / stride;
+            else
+                ++work;
+        }
+        return work;
+    }
+
+    void Figure::begin_pass()
+    {
+        canvas_.setTo(background());
+        draw_grid(prog_.xt, prog_.yt);
+        draw_axes(prog_.xt, prog_.yt);
+    }
+
+    void Figure::render_quality(RenderQuality q)
+    {
+        if (q != quality_) { quality_ = q; dirty_ = true; }
+        for (auto& sp : subplots_) sp.render_quality(q);
+    }
+
+    void Figure::canvas_format(CanvasFormat f)
+    {
+        if (f == format_) return;
+        apply_format(f);
+        rebind_canvas(cv::Mat(height_, width_, canvas_type(f), background()));
+        buffer_count(buffer_count());   /* reallocates published frames in the new type */
+    }
+
+    void Figure::apply_format(CanvasFormat f)
+    {
+        format_ = f;
+        image_cache_.clear();
+        ylabel_cache_valid_ = false;
+        prog_.active = false;
+        dirty_ = true;
+        for (auto& sp : subplots_) sp.apply_format(f);
+    }
+
+    void Figure::collect_stats(bool on)
+    {
+        stats_on_ = on;
+        for (auto& sp : subplots_) sp.collect_stats(on);
+    }
+
+    void Figure::show(const std::string& window_name)
+    {
+        if (!prog_.active || dirty_) render();   /* mid-sequence: show the latest complete pass */
+        swap_buffers();
+        MPOCV_TRACE_SCOPE("show");
+        cv::imshow(window_name, front());
+        cv::waitKey(1);
+    }
+
+    void Figure::buffer_count(int n)
+    {
+        n = std::max(1, std::min(3, n));
+        frames_.resize(static_cast<size_t>(n - 1));
+        for (auto& f : frames_)
+        {
+            if (f.size() != canvas_.size() || f.type() != canvas_.type()) canvas_.copyTo(f);
+        }
+    }
+
+    void Figure::swap_buffers()
+    {
+        if (frames_.empty()) return;
+        MPOCV_TRACE_SCOPE("swap_buffers");
+
+        /* rotate: canvas -> front, oldest published -> render target */
+        cv::Mat target = std::move(frames_.back());
+        frames_.pop_back();
+        frames_.insert(frames_.begin(), canvas_);
+        if (target.size() != canvas_.size() || target.type() != canvas_.type())
+            target.create(canvas_.size(), canvas_.type());
+
+        /* a full redraw overwrites everything anyway; otherwise carry the frame over */
+        if (!dirty_) frames_.front().copyTo(target);
+        rebind_canvas(target);
+    }
+
+    void Figure::rebind_canvas(const cv::Mat& target)
+    {
+        canvas_ = target;
+        for (int i = 0; i < static_cast<int>(subplots_.size()); ++i)
+            subplots_[i].rebind_canvas(canvas_(subplot_rect(i)));
+    }
+
+    void Figure::save(const std::string& filename, const EncodeParams& params)
+    {
+        if (has_extension(filename, ".svg")) { save_svg(filename); return; }
+
+        render_for_encode(params.final_quality);
+        {
+            MPOCV_TRACE_SCOPE("save_encode");
+            cv::imwrite(filename, encodable(filename), encode_flags(filename, params));
+        }
+    }
+
+    bool Figure::encode(const std::string& format, std::vector<uint8_t>& out, const EncodeParams& params)
+    {
+        out.clear();   /* keeps the capacity for the next frame */
+        const std::string ext = format.empty() || format[0] == '.' ? format : "." + format;
+        if (ext.size() < 2 || has_extension(ext, ".svg")) return false;
+
+        render_for_encode(params.final_quality);
+        bool ok = false;
+        {
+            MPOCV_TRACE_SCOPE("encode");
+            try
+            {
+                ok = cv::imencode(ext, encodable(ext), out, encode_flags(ext, params));
+            }
+            catch (const cv::Exception&)
+            {
+                ok = false;   /* no encoder for this extension in the OpenCV build */
+            }
+        }
+        if (!ok) out.clear();
+        return ok;
+    }
+
+    std::vector<uint8_t> Figure::encode(const std::string& format, const EncodeParams& params)
+    {
+        std::vector<uint8_t> out;
+        encode(format, out, params);
+        return out;
+    }
+
+    void Figure::render_for_encode(bool final_quality)
+    {
+        /* files get full quality unless asked otherwise. A canvas already drawn at Final is
+           encoded as is, and the interactive setting comes back without a redraw, since a
+           Final canvas is at least as good */
+        drain_feeds();
+        const RenderQuality q = quality_;
+        if (!final_quality || q == RenderQuality::Final || drawn_at(RenderQuality::Final))
+        {
+            render();
+            return;
+        }
+        render_quality(RenderQuality::Final);
+        render();
+        restore_quality(q);
+    }
+
+    bool Figure::drawn_at(RenderQuality q) const
+    {
+        if (dirty_ || prog_.active || drawn_quality_ != q) return false;
+        for (const auto& sp : subplots_)
+            if (!sp.drawn_at(q)) return false;
+        return true;
+    }
+
+    void Figure::restore_quality(RenderQuality q)
+    {
+        quality_ = q;
+        for (auto& sp : subplots_) sp.restore_quality(q);
+    }
+
+    const cv::Mat& Figure::encodable(const std::string& ext)
+    {
+        const bool png_or_tiff = has_extension(ext, ".png") || has_extension(ext, ".tif") || has_extension(ext, ".tiff");
+        if (canvas_.type() == CV_8UC4)
+        {
+            /* files store straight alpha; formats without alpha (JPEG, MJPEG) get the
+               figure flattened onto white, as a BGR8 canvas would have drawn it */
+            const bool keep_alpha = png_or_tiff || has_extension(ext, ".webp");
+            encode_scratch_.create(canvas_.size(), keep_alpha ? CV_8UC4 : CV_8UC3);
+            for (int r = 0; r < canvas_.rows; ++r)
+            {
+                const uchar* s = canvas_.ptr<uchar>(r);
+                uchar* d = encode_scratch_.ptr<uchar>(r);
+                for (int c = 0; c < canvas_.cols; ++c, s += 4)
+                {
+                    const int a = s[3];
+                    if (keep_alpha)
+                    {
+                        for (int k = 0; k < 3; ++k) d[k] = a == 0 ? 0 : static_cast<uchar>(std::min(255, (s[k] * 255 + a / 2) / a));
+                        d[3] = static_cast<uchar>(a);
+                        d += 4;
+                    }
+                    else
+                    {
+                        for (int k = 0; k < 3; ++k) d[k] = static_cast<uchar>(std::min(255, s[k] + 255 - a));
+                        d += 3;
+                    }
+                }
+            }
+            return encode_scratch_;
+        }
+        if (canvas_.depth() != CV_16U || png_or_tiff)
+            return canvas_;
+        /* 8-bit-only encoders would saturate instead of scaling */
+        canvas_.convertTo(encode_scratch_, CV_8U, 1.0 / 257.0);
+        return encode_scratch_;
+    }
+
+    void Figure::render_subplots()
+    {
+        bool any_dirty = dirty_;
+        for (const auto& sp : subplots_) any_dirty = any_dirty || sp.dirty_;
+        if (!any_dirty) return;
+
+        /* the grid itself changed: clear everything and redraw every cell */
+        if (dirty_)
+        {
+            layout_subplots();
+            canvas_.setTo(background());
+            drawn_quality_ = quality_;
+            if (!title_.empty())
+            {
+                cv::putText(canvas_, title_, { kMargin, kMargin / 2 }, cv::FONT_HERSHEY_SIMPLEX, 0.6, cv_color(Color::Black()), 1, line_type(quality_, Prim::Text));
+            }
+            for (auto& sp : subplots_) sp.dirty_ = true;
+        }
+
+        MPOCV_TRACE_SCOPE("render_subplots");
+        if (stats_on_) stats_.reset();
+        StageTimer total(stats_on_ ? &stats_.total_ns : nullptr);
+        std::vector<char> redrawn(subplots_.size(), 0);
+        for (size_t i = 0; i < subplots_.size(); ++i) redrawn[i] = subplots_[i].dirty_;
 
-        for (size_t i = 0; i < x.size(); ++i)
-            data_bounds_.expand(x[i], y[i]);
+        /* each cell owns a disjoint ROI of canvas_, so cells can draw concurrently */
+        cv::parallel_for_(cv::Range(0, static_cast<int>(subplots_.size())), [this](const cv::Range& r)
+            {
+                for (int i = r.start; i < r.end; ++i) subplots_[i].render();
+            });
 
-        cmds_.push_back(std::move(cmd));
-        dirty_ = true;
+        if (stats_on_)
+        {
+            for (size_t i = 0; i < subplots_.size(); ++i)
+                if (redrawn[i]) stats_.add(subplots_[i].stats_);
+        }
+        dirty_ = false;
+        ++frame_seq_;
     }
 
-    void Figure::ellipse(double cx, double cy, double w, double h, double angle_deg,
-        const ShapeStyle& style, const std::string& label)
-    {
-        PlotCommand cmd;
-        cmd.type = CmdType::Ellipse;
-        cmd.ellipse = { cx, cy, w, h, angle_deg, style };
-        cmd.label = label;
-        data_bounds_.expand(cx - 0.5 * w, cy - 0.5 * h);
-        data_bounds_.expand(cx + 0.5 * w, cy + 0.5 * h);
-        cmds_.push_back(std::move(cmd));
-        dirty_ = true;
-    }
 
-    // ---------------------------------------------------------------------------
-    // Rendering & I/O
-    // ---------------------------------------------------------------------------
-    void Figure::render()
-    {
-        if (!dirty_) return;
 
-        /* 1) autoscale --------------------------------------------------------- */
+
+    /* --------------------------------------------------------------------------
+     *  Render stages
+     * ------------------------------------------------------------------------*/
+    void Figure::update_limits()
+    {
         if (axes_.autoscale)
         {
+            resolve_pending_bounds();
             if (data_bounds_.valid())
             {
                 axes_.xmin = data_bounds_.xmin; axes_.xmax = data_bounds_.xmax;
@@ -191,8 +1338,9 @@ namespace mpocv
             else { axes_.xmin = 0; axes_.xmax = 1; axes_.ymin = 0; axes_.ymax = 1; }
         }
 
-        /* 1b) optional padding -------------------------------------------------- */
-        if (axes_.pad_frac > 0.0)
+        /* optional padding, around autoscaled limits only (user limits are kept as set,
+           so re-rendering with fixed limits does not keep widening them) */
+        if (axes_.autoscale && axes_.pad_frac > 0.0)
         {
             const double dx = (axes_.xmax - axes_.xmin) * axes_.pad_frac;
             const double dy = (axes_.ymax - axes_.ymin) * axes_.pad_frac;
@@ -201,7 +1349,7 @@ namespace mpocv
         }
         fix_ranges(axes_);
 
-        /* 2) equal?scale -------------------------------------------------------- */
+        /* equal-scale */
         if (axes_.equal_scale)
         {
             const double xrange = axes_.xmax - axes_.xmin;
@@ -213,258 +1361,662 @@ namespace mpocv
             axes_.ymin = ymid - span / 2; axes_.ymax = ymid + span / 2;
         }
         fix_ranges(axes_);
+    }
 
-        /* 3) ticks ------------------------------------------------------------- */
-        const TickInfo xt = make_ticks(axes_.xmin, axes_.xmax);
-        const TickInfo yt = make_ticks(axes_.ymin, axes_.ymax);
-
-        /* 4) clear canvas ------------------------------------------------------ */
-        canvas_.setTo(cv::Scalar(255, 255, 255));
-
-        /* 5) grid & axes ------------------------------------------------------- */
-        draw_grid(xt, yt);
-        draw_axes(xt, yt);
-
-        /* 6) retained commands ------------------------------------------------- */
-        for (const auto& cmd : cmds_)
+    void Figure::draw_command(const PlotCommand& cmd)
+    {
+        const cv::Scalar cvcol = cv_color(cmd.color);
+        int lt_fill = line_type(quality_, Prim::Fill);
+        int lt_edge = line_type(quality_, Prim::Segment);
+        switch (cmd.type)
         {
-            const cv::Scalar cvcol(cmd.color.b, cmd.color.g, cmd.color.r);
-            switch (cmd.type)
-            {
-            case CmdType::Line:
+        case CmdType::Line:
+        case CmdType::Scatter:
+            draw_series_chunk(cmd, 0, 1, std::numeric_limits<size_t>::max());
+            break;
+        case CmdType::Text:
+        {
+            const std::string& text = scratch_text(cmd.txt().text);
+            const cv::Point2i p = anchored_text_pos(cmd.txt(), text);
+            cv::putText(canvas_, text, p, cv::FONT_HERSHEY_SIMPLEX,
+                cmd.txt().font_scale, cvcol, cmd.txt().thickness, line_type(quality_, Prim::Text));
+            ++stats_.primitives_drawn;
+            break;
+        }
+        /* --- shape commands (Circle / Rect / RotRect / Poly / Ellipse) --- */
+        case CmdType::Circle:
+        {
+            const auto& d = cmd.circle();
+            const cv::Point center = data_to_pixel(d.cx, d.cy);
+            const int radius_px = static_cast<int>(d.radius * plot_width() / (axes_.xmax - axes_.xmin));
+
+            if (d.style.fill_alpha > 0.0f && d.style.fill_alpha < 1.0f)
             {
-                const auto& X = cmd.line.x;
-                const auto& Y = cmd.line.y;
-                for (size_t i = 1; i < X.size(); ++i)
+                const cv::Rect roi = grow(cv::Rect(center.x - radius_px, center.y - radius_px, 2 * radius_px, 2 * radius_px), 2) & cv::Rect(0, 0, canvas_.cols, canvas_.rows);
+                if (!roi.empty())
                 {
-                    cv::line(canvas_, data_to_pixel(X[i - 1], Y[i - 1]),
-                        data_to_pixel(X[i], Y[i]), cvcol,
-                        static_cast<int>(cmd.line.thickness), cv::LINE_AA);
+                    cv::Mat& tmp = blend_scratch(roi);
+                    cv::circle(tmp, center, radius_px, cv_color(d.style.fill_color), cv::FILLED, lt_fill);
+                    blend_shape(tmp(roi), roi, d.style.fill_alpha);
                 }
-                break;
             }
-            case CmdType::Scatter:
+            else if (d.style.fill_alpha >= 1.0f)
             {
-                const auto& X = cmd.scatter.x;
-                const auto& Y = cmd.scatter.y;
-                for (size_t i = 0; i < X.size(); ++i)
-                {
-                    cv::circle(canvas_, data_to_pixel(X[i], Y[i]),
-                        static_cast<int>(cmd.scatter.marker_size),
-                        cvcol, cv::FILLED, cv::LINE_AA);
-                }
-                break;
+                cv::circle(canvas_, center, radius_px, cv_color(d.style.fill_color), cv::FILLED, lt_fill);
             }
-            case CmdType::Text:
+            if (d.style.thickness > 0.0f)
             {
-                const cv::Point2i p = anchored_text_pos(cmd.txt);
-                cv::putText(canvas_, cmd.txt.text, p, cv::FONT_HERSHEY_SIMPLEX,
-                    cmd.txt.font_scale, cvcol, cmd.txt.thickness, cv::LINE_AA);
-                break;
+                cv::circle(canvas_, center, radius_px, cv_color(d.style.line_color),
+                    static_cast<int>(d.style.thickness), lt_edge);
             }
-            /* --- shape commands (Circle / Rect / RotRect / Poly / Ellipse) --- */
-            case CmdType::Circle:
-            {
-                const auto& d = cmd.circle;
-                const cv::Point center = data_to_pixel(d.cx, d.cy);
-                const int radius_px = static_cast<int>(d.radius * plot_width() / (axes_.xmax - axes_.xmin));
+            stats_.primitives_drawn += shape_primitives(d.style);
+            break;
+        }
+        case CmdType::RectXYWH:
+        case CmdType::RectLTRB:
+        {
+            const auto& d = cmd.rect();
+            const cv::Point p0 = data_to_pixel(d.x0, d.y0);
+            const cv::Point p1 = data_to_pixel(d.x1, d.y1);
+            const cv::Rect  r(p0, p1);
+            lt_fill = lt_edge = line_type(quality_, Prim::AxisAligned);   /* AA adds nothing to straight edges */
 
-                if (d.style.fill_alpha > 0.0f && d.style.fill_alpha < 1.0f)
-                {
-                    cv::Mat tmp = canvas_.clone();
-                    cv::circle(tmp, center, radius_px, cv_color(d.style.fill_color), cv::FILLED, cv::LINE_AA);
-                    blend_shape(tmp, d.style.fill_alpha);
-                }
-                else if (d.style.fill_alpha >= 1.0f)
-                {
-                    cv::circle(canvas_, center, radius_px, cv_color(d.style.fill_color), cv::FILLED, cv::LINE_AA);
-                }
-                if (d.style.thickness > 0.0f)
+            if (d.style.fill_alpha > 0.0f && d.style.fill_alpha < 1.0f)
+            {
+                const cv::Rect roi = grow(r, 2) & cv::Rect(0, 0, canvas_.cols, canvas_.rows);
+                if (!roi.empty())
                 {
-                    cv::circle(canvas_, center, radius_px, cv_color(d.style.line_color),
-                        static_cast<int>(d.style.thickness), cv::LINE_AA);
+                    cv::Mat& tmp = blend_scratch(roi);
+                    cv::rectangle(tmp, r, cv_color(d.style.fill_color), cv::FILLED, lt_fill);
+                    blend_shape(tmp(roi), roi, d.style.fill_alpha);
                 }
-                break;
             }
-            case CmdType::RectXYWH:
-            case CmdType::RectLTRB:
+            else if (d.style.fill_alpha >= 1.0f)
+            {
+                cv::rectangle(canvas_, r, cv_color(d.style.fill_color), cv::FILLED, lt_fill);
+            }
+            if (d.style.thickness > 0.0f)
             {
-                const auto& d = cmd.rect;
-                const cv::Point p0 = data_to_pixel(d.x0, d.y0);
-                const cv::Point p1 = data_to_pixel(d.x1, d.y1);
-                const cv::Rect  r(p0, p1);
+                cv::rectangle(canvas_, r, cv_color(d.style.line_color),
+                    static_cast<int>(d.style.thickness), lt_edge);
+            }
+            stats_.primitives_drawn += shape_primitives(d.style);
+            break;
+        }
+        case CmdType::RotatedRect:
+        {
+            const auto& d = cmd.rot_rect();
+            cv::RotatedRect r(data_to_pixel(d.cx, d.cy),
+                cv::Size2f(static_cast<float>(d.width * plot_width() / (axes_.xmax - axes_.xmin)),
+                    static_cast<float>(d.height * plot_height() / (axes_.ymax - axes_.ymin))),
+                static_cast<float>(-d.angle_deg));
+            cv::Point2f verts[4]; r.points(verts);
+            std::vector<cv::Point> pts(4);
+            for (int i = 0; i < 4; ++i) pts[i] = verts[i];
 
-                if (d.style.fill_alpha > 0.0f && d.style.fill_alpha < 1.0f)
-                {
-                    cv::Mat tmp = canvas_.clone();
-                    cv::rectangle(tmp, r, cv_color(d.style.fill_color), cv::FILLED, cv::LINE_AA);
-                    blend_shape(tmp, d.style.fill_alpha);
-                }
-                else if (d.style.fill_alpha >= 1.0f)
-                {
-                    cv::rectangle(canvas_, r, cv_color(d.style.fill_color), cv::FILLED, cv::LINE_AA);
-                }
-                if (d.style.thickness > 0.0f)
+            if (d.style.fill_alpha > 0.0f && d.style.fill_alpha < 1.0f)
+            {
+                const cv::Rect roi = grow(cv::boundingRect(pts), 2) & cv::Rect(0, 0, canvas_.cols, canvas_.rows);
+                if (!roi.empty())
                 {
-                    cv::rectangle(canvas_, r, cv_color(d.style.line_color),
-                        static_cast<int>(d.style.thickness), cv::LINE_AA);
+                    cv::Mat& tmp = blend_scratch(roi);
+                    cv::fillConvexPoly(tmp, pts, cv_color(d.style.fill_color), lt_fill);
+                    blend_shape(tmp(roi), roi, d.style.fill_alpha);
                 }
-                break;
             }
-            case CmdType::RotatedRect:
+            else if (d.style.fill_alpha >= 1.0f)
+            {
+                cv::fillConvexPoly(canvas_, pts, cv_color(d.style.fill_color), lt_fill);
+            }
+            if (d.style.thickness > 0.0f)
             {
-                const auto& d = cmd.rot_rect;
-                cv::RotatedRect r(data_to_pixel(d.cx, d.cy),
-                    cv::Size2f(static_cast<float>(d.width * plot_width() / (axes_.xmax - axes_.xmin)),
-                        static_cast<float>(d.height * plot_height() / (axes_.ymax - axes_.ymin))),
-                    static_cast<float>(-d.angle_deg));
-                cv::Point2f verts[4]; r.points(verts);
-                std::vector<cv::Point> pts(4);
-                for (int i = 0; i < 4; ++i) pts[i] = verts[i];
+                cv::polylines(canvas_, pts, true, cv_color(d.style.line_color),
+                    static_cast<int>(d.style.thickness), lt_edge);
+            }
+            stats_.primitives_drawn += shape_primitives(d.style);
+            break;
+        }
+        case CmdType::Polygon:
+        {
+            const auto& d = cmd.polygon();
+            std::vector<cv::Point> pts;
+            for (size_t i = 0; i < d.x.size(); ++i)
+                pts.push_back(data_to_pixel(d.x[i], d.y[i]));
 
-                if (d.style.fill_alpha > 0.0f && d.style.fill_alpha < 1.0f)
-                {
-                    cv::Mat tmp = canvas_.clone();
-                    cv::fillConvexPoly(tmp, pts, cv_color(d.style.fill_color), cv::LINE_AA);
-                    blend_shape(tmp, d.style.fill_alpha);
-                }
-                else if (d.style.fill_alpha >= 1.0f)
-                {
-                    cv::fillConvexPoly(canvas_, pts, cv_color(d.style.fill_color), cv::LINE_AA);
-                }
-                if (d.style.thickness > 0.0f)
+            if (d.style.fill_alpha > 0.0f && d.style.fill_alpha < 1.0f)
+            {
+                const cv::Rect roi = grow(cv::boundingRect(pts), 2) & cv::Rect(0, 0, canvas_.cols, canvas_.rows);
+                if (!roi.empty())
                 {
-                    cv::polylines(canvas_, pts, true, cv_color(d.style.line_color),
-                        static_cast<int>(d.style.thickness), cv::LINE_AA);
+                    cv::Mat& tmp = blend_scratch(roi);
+                    cv::fillPoly(tmp, std::vector<std::vector<cv::Point>>{ pts }, cv_color(d.style.fill_color), lt_fill);
+                    blend_shape(tmp(roi), roi, d.style.fill_alpha);
                 }
-                break;
             }
-            case CmdType::Polygon:
+            else if (d.style.fill_alpha >= 1.0f)
+            {
+                cv::fillPoly(canvas_, std::vector<std::vector<cv::Point>>{ pts }, cv_color(d.style.fill_color), lt_fill);
+            }
+            if (d.style.thickness > 0.0f)
             {
-                const auto& d = cmd.polygon;
-                std::vector<cv::Point> pts;
-                for (size_t i = 0; i < d.x.size(); ++i)
-                    pts.push_back(data_to_pixel(d.x[i], d.y[i]));
+                cv::polylines(canvas_, pts, true, cv_color(d.style.line_color),
+                    static_cast<int>(d.style.thickness), lt_edge);
+            }
+            stats_.primitives_drawn += shape_primitives(d.style);
+            break;
+        }
+        case CmdType::Ellipse:
+        {
+            const auto& d = cmd.ellipse();
+            const cv::Point center = data_to_pixel(d.cx, d.cy);
+            const cv::Size axes(static_cast<int>(0.5 * d.width * plot_width() / (axes_.xmax - axes_.xmin)),
+                static_cast<int>(0.5 * d.height * plot_height() / (axes_.ymax - axes_.ymin)));
+            const int reach = std::max(axes.width, axes.height);
 
-                if (d.style.fill_alpha > 0.0f && d.style.fill_alpha < 1.0f)
-                {
-                    cv::Mat tmp = canvas_.clone();
-                    cv::fillPoly(tmp, std::vector<std::vector<cv::Point>>{ pts }, cv_color(d.style.fill_color), cv::LINE_AA);
-                    blend_shape(tmp, d.style.fill_alpha);
-                }
-                else if (d.style.fill_alpha >= 1.0f)
-                {
-                    cv::fillPoly(canvas_, std::vector<std::vector<cv::Point>>{ pts }, cv_color(d.style.fill_color), cv::LINE_AA);
-                }
-                if (d.style.thickness > 0.0f)
+            if (d.style.fill_alpha > 0.0f && d.style.fill_alpha < 1.0f)
+            {
+                const cv::Rect roi = grow(cv::Rect(center.x - reach, center.y - reach, 2 * reach, 2 * reach), 2) & cv::Rect(0, 0, canvas_.cols, canvas_.rows);
+                if (!roi.empty())
                 {
-                    cv::polylines(canvas_, pts, true, cv_color(d.style.line_color),
-                        static_cast<int>(d.style.thickness), cv::LINE_AA);
+                    cv::Mat& tmp = blend_scratch(roi);
+                    cv::ellipse(tmp, center, axes, -d.angle_deg, 0, 360, cv_color(d.style.fill_color), cv::FILLED, lt_fill);
+                    blend_shape(tmp(roi), roi, d.style.fill_alpha);
                 }
-                break;
             }
-            case CmdType::Ellipse:
+            else if (d.style.fill_alpha >= 1.0f)
+            {
+                cv::ellipse(canvas_, center, axes, -d.angle_deg, 0, 360, cv_color(d.style.fill_color), cv::FILLED, lt_fill);
+            }
+            if (d.style.thickness > 0.0f)
+            {
+                cv::ellipse(canvas_, center, axes, -d.angle_deg, 0, 360, cv_color(d.style.line_color),
+                    static_cast<int>(d.style.thickness), lt_edge);
+            }
+            stats_.primitives_drawn += shape_primitives(d.style);
+            break;
+        }
+        case CmdType::Image:
+            draw_image(cmd.image());
+            break;
+        case CmdType::Histogram:
+            draw_hist(cmd.hist());
+            break;
+        case CmdType::FillBetween:
+            draw_band(cmd.band());
+            break;
+        case CmdType::LineMatrix:
+            draw_line_matrix(cmd.matrix());
+            break;
+        case CmdType::Segments:
+        {
+            const auto& d = cmd.segments();
+            const size_t n = std::min(d.x.size(), d.y.size()) / 2;
+            const int th = std::max(1, static_cast<int>(d.thickness));
+            const int lt = line_type(quality_, Prim::Segment);
+            const cv::Rect area = cull_rect(canvas_, th);
+            const bool per_color = d.color_index.size() >= n;
+            cv::Scalar lut[256];
+            if (per_color) scalar_lut(d.cmap, format_, lut);
+            size_t drawn = 0;
+            for (size_t k = 0; k < n; ++k)
             {
-                const auto& d = cmd.ellipse;
-                const cv::Point center = data_to_pixel(d.cx, d.cy);
-                const cv::Size axes(static_cast<int>(0.5 * d.width * plot_width() / (axes_.xmax - axes_.xmin)),
-                    static_cast<int>(0.5 * d.height * plot_height() / (axes_.ymax - axes_.ymin)));
+                const cv::Point2i p0 = data_to_pixel(d.ox + d.sx * d.x[2 * k], d.oy + d.sy * d.y[2 * k]);
+                const cv::Point2i p1 = data_to_pixel(d.ox + d.sx * d.x[2 * k + 1], d.oy + d.sy * d.y[2 * k + 1]);
+                if ((outcode(p0, area) & outcode(p1, area)) != 0) continue;
+                cv::line(canvas_, p0, p1, per_color ? lut[static_cast<int>(d.color_index[k]) & 255] : cvcol, th, lt);
+                ++drawn;
+            }
+            stats_.primitives_drawn += drawn;
+            stats_.points_culled += n - drawn;
+            break;
+        }
+        }
+    }
 
-                if (d.style.fill_alpha > 0.0f && d.style.fill_alpha < 1.0f)
-                {
-                    cv::Mat tmp = canvas_.clone();
-                    cv::ellipse(tmp, center, axes, -d.angle_deg, 0, 360, cv_color(d.style.fill_color), cv::FILLED, cv::LINE_AA);
-                    blend_shape(tmp, d.style.fill_alpha);
-                }
-                else if (d.style.fill_alpha >= 1.0f)
-                {
-                    cv::ellipse(canvas_, center, axes, -d.angle_deg, 0, 360, cv_color(d.style.fill_color), cv::FILLED, cv::LINE_AA);
-                }
-                if (d.style.thickness > 0.0f)
-                {
-                    cv::ellipse(canvas_, center, axes, -d.angle_deg, 0, 360, cv_color(d.style.line_color),
-                        static_cast<int>(d.style.thickness), cv::LINE_AA);
-                }
-                break;
+    bool Figure::colorize_image(const ImageData& d, ImageInterp interp, cv::Rect& dst, cv::Mat& bgr) const
+    {
+        if (d.rows <= 0 || d.cols <= 0 || d.values.size() < static_cast<size_t>(d.rows) * d.cols) return false;
+
+        /* pixel geometry of the extent (pixel i is centred on coordinate i, as in data_to_pixel) */
+        const double ppx = plot_width() / (axes_.xmax - axes_.xmin);
+        const double ppy = plot_height() / (axes_.ymax - axes_.ymin);
+        const double left = kMarginLeft + (d.x0 - axes_.xmin) * ppx;
+        const double top = height_ - kMarginBottom - (d.y1 - axes_.ymin) * ppy;
+        const double cw = (d.x1 - d.x0) * ppx / d.cols;   /* cell size in pixels */
+        const double ch = (d.y1 - d.y0) * ppy / d.rows;
+        if (!(cw > 0.0 && ch > 0.0) || !std::isfinite(left) || !std::isfinite(top)) return false;
+
+        const cv::Rect plot = cv::Rect(kMarginLeft, kMarginTop, plot_width() + 1, plot_height() + 1)
+            & cv::Rect(0, 0, canvas_.cols, canvas_.rows);
+        const cv::Point tl(static_cast<int>(std::lround(clamp_px(left))), static_cast<int>(std::lround(clamp_px(top))));
+        const cv::Point br(static_cast<int>(std::lround(clamp_px(left + cw * d.cols))), static_cast<int>(std::lround(clamp_px(top + ch * d.rows))));
+        dst = cv::Rect(tl, br) & plot;
+        if (dst.empty()) return false;
+
+        /* only the visible cells (plus one for bilinear neighbours) are resampled */
+        auto first_cell = [](double px, double origin, double size, int n)
+            {
+                return static_cast<int>(std::min<double>(n, std::max(0.0, std::floor((px - origin) / size) - 1.0)));
+            };
+        auto end_cell = [](double px, double origin, double size, int n)
+            {
+                return static_cast<int>(std::min<double>(n, std::max(0.0, std::floor((px - origin) / size) + 2.0)));
+            };
+        const int c0 = first_cell(dst.x, left, cw, d.cols), c1 = end_cell(dst.x + dst.width, left, cw, d.cols);
+        const int r0 = first_cell(dst.y, top, ch, d.rows), r1 = end_cell(dst.y + dst.height, top, ch, d.rows);
+        if (c0 >= c1 || r0 >= r1) return false;
+
+        cv::Mat src = image_source(d)(cv::Range(r0, r1), cv::Range(c0, c1));
+        double ex = cw, ey = ch;   /* source cell size in pixels */
+        if (interp == ImageInterp::Bilinear && (cw < 1.0 || ch < 1.0))
+        {
+            /* shrink by area averaging first, so the warp below never skips cells */
+            const int w = cw < 1.0 ? std::max(1, static_cast<int>(std::lround((c1 - c0) * cw))) : c1 - c0;
+            const int h = ch < 1.0 ? std::max(1, static_cast<int>(std::lround((r1 - r0) * ch))) : r1 - r0;
+            cv::Mat shrunk;
+            cv::resize(src, shrunk, cv::Size(w, h), 0, 0, cv::INTER_AREA);
+            ex = (c1 - c0) * cw / w;
+            ey = (r1 - r0) * ch / h;
+            src = shrunk;
+        }
+
+        /* inverse map canvas pixel -> source position; bilinear samples relative to cell
+           centres, INTER_NEAREST floors, so it gets cell edges */
+        const double shift = interp == ImageInterp::Bilinear ? 0.5 : 0.0;
+        double m[6] = { 1.0 / ex, 0.0, (dst.x - (left + c0 * cw)) / ex - shift,
+                        0.0, 1.0 / ey, (dst.y - (top + r0 * ch)) / ey - shift };
+        cv::Mat values;
+        cv::warpAffine(src, values, cv::Mat(2, 3, CV_64F, m), dst.size(),
+            (interp == ImageInterp::Bilinear ? cv::INTER_LINEAR : cv::INTER_NEAREST) | cv::WARP_INVERSE_MAP,
+            cv::BORDER_REPLICATE);
+
+        /* values -> LUT index -> color */
+        const double scale = 255.0 / (d.vmax > d.vmin ? d.vmax - d.vmin : 1.0);
+        cv::Mat index;
+        values.convertTo(index, CV_8U, scale, -d.vmin * scale);
+        cv::Mat lut(256, 1, CV_8UC3);
+        const Color* cm = colormap_lut(d.cmap);
+        for (int k = 0; k < 256; ++k)
+        {
+            cv::Vec3b& e = lut.at<cv::Vec3b>(k);
+            e[0] = cm[k].b; e[1] = cm[k].g; e[2] = cm[k].r;
+        }
+        cv::applyColorMap(index, bgr, lut);
+        return true;
+    }
+
+    void Figure::draw_image(const ImageData& d)
+    {
+        const ImageInterp interp = quality_ == RenderQuality::Draft ? ImageInterp::Nearest : d.interp;
+        for (const auto& e : image_cache_)
+        {
+            if (e.id != d.id || e.width != width_ || e.height != height_ || e.interp != interp || !same_limits(e.axes, axes_)) continue;
+            e.bgr.copyTo(canvas_(e.dst));
+            ++stats_.primitives_drawn;
+            return;
+        }
+
+        ImageCacheEntry entry;
+        if (!colorize_image(d, interp, entry.dst, entry.bgr)) return;
+        bgr_to_format(entry.bgr, format_);   /* cached in the canvas format, copied as is on later frames */
+        entry.bgr.copyTo(canvas_(entry.dst));
+        ++stats_.primitives_drawn;
+
+        /* replace this image's stale entry and drop entries of removed commands */
+        image_cache_.erase(std::remove_if(image_cache_.begin(), image_cache_.end(), [&](const ImageCacheEntry& e)
+            {
+                return e.id == d.id || std::none_of(cmds_.begin(), cmds_.end(), [&](const PlotCommand& c)
+                    { return c.type == CmdType::Image && c.image().id == e.id; });
+            }), image_cache_.end());
+        entry.id = d.id;
+        entry.axes = axes_;
+        entry.width = width_;
+        entry.height = height_;
+        entry.interp = interp;
+        image_cache_.push_back(std::move(entry));
+    }
+
+    Figure::HistCacheEntry& Figure::hist_entry(uint64_t id)
+    {
+        for (auto& e : hist_cache_)
+            if (e.id == id) return e;
+
+        /* drop entries of removed commands before adding one */
+        hist_cache_.erase(std::remove_if(hist_cache_.begin(), hist_cache_.end(), [&](const HistCacheEntry& e)
+            {
+                return std::none_of(cmds_.begin(), cmds_.end(), [&](const PlotCommand& c)
+                    { return c.type == CmdType::Histogram && c.hist().id == e.id; });
+            }), hist_cache_.end());
+        hist_cache_.emplace_back();
+        hist_cache_.back().id = id;
+        return hist_cache_.back();
+    }
+
+    bool Figure::hist_range(const HistData& d, double& lo, double& hi)
+    {
+        HistCacheEntry& e = hist_entry(d.id);
+        if (!e.have_range)
+        {
+            MPOCV_TRACE_SCOPE("hist_range");
+            if (!finite_min_max(d.data, e.dmin, e.dmax)) return false;
+            if (e.dmin == e.dmax) { e.dmin -= 0.5; e.dmax += 0.5; }
+            e.have_range = true;
+        }
+        lo = e.dmin; hi = e.dmax;
+        return true;
+    }
+
+    const std::vector<uint64_t>& Figure::hist_counts(const HistData& d, double lo, double hi)
+    {
+        HistCacheEntry& e = hist_entry(d.id);
+        if (e.counts.size() != static_cast<size_t>(d.bins) || e.lo != lo || e.hi != hi)
+        {
+            MPOCV_TRACE_SCOPE("hist_counts");
+            histogram_counts(d.data, lo, hi, static_cast<size_t>(d.bins), e.counts);
+            e.lo = lo; e.hi = hi;
+        }
+        return e.counts;
+    }
+
+    const std::vector<uint64_t>* Figure::hist_bins(const HistData& d, double& lo, double& hi)
+    {
+        /* autoscaled bins span the samples; fixed limits re-bin the visible range */
+        lo = axes_.xmin; hi = axes_.xmax;
+        if (axes_.autoscale && !hist_range(d, lo, hi)) return nullptr;
+        return &hist_counts(d, lo, hi);
+    }
+
+    void Figure::draw_hist(const HistData& d)
+    {
+        double lo, hi;
+        const std::vector<uint64_t>* bins = hist_bins(d, lo, hi);
+        if (!bins) return;
+        const std::vector<uint64_t>& counts = *bins;
+
+        /* one quad per non-empty bin; heights clamped so far-off limits cannot overflow */
+        const double w = (hi - lo) / counts.size();
+        const double span = axes_.ymax - axes_.ymin;
+        auto clamp_y = [&](double y) { return std::min(std::max(y, axes_.ymin - span), axes_.ymax + span); };
+        const double base = clamp_y(0.0);
+        std::vector<std::vector<cv::Point>> bars;
+        bars.reserve(counts.size());
+        for (size_t i = 0; i < counts.size(); ++i)
+        {
+            if (counts[i] == 0) continue;
+            const double top = clamp_y(static_cast<double>(counts[i]));
+            const cv::Point2i a = data_to_pixel(lo + w * i, base);
+            const cv::Point2i b = data_to_pixel(lo + w * (i + 1), top);
+            bars.push_back({ a, { b.x, a.y }, b, { a.x, b.y } });
+        }
+        if (bars.empty()) return;
+
+        const int lt_fill = line_type(quality_, Prim::AxisAligned);
+        if (d.style.fill_alpha > 0.0f && d.style.fill_alpha < 1.0f)
+        {
+            cv::Rect box = cv::boundingRect(bars.front());
+            for (const auto& q : bars) box |= cv::boundingRect(q);
+            const cv::Rect roi = grow(box, 2) & cv::Rect(0, 0, canvas_.cols, canvas_.rows);
+            if (!roi.empty())
+            {
+                cv::Mat& tmp = blend_scratch(roi);
+                cv::fillPoly(tmp, bars, cv_color(d.style.fill_color), lt_fill);
+                blend_shape(tmp(roi), roi, d.style.fill_alpha);
             }
+        }
+        else if (d.style.fill_alpha >= 1.0f)
+        {
+            cv::fillPoly(canvas_, bars, cv_color(d.style.fill_color), lt_fill);
+        }
+        if (d.style.thickness > 0.0f)
+        {
+            cv::polylines(canvas_, bars, true, cv_color(d.style.line_color),
+                static_cast<int>(d.style.thickness), lt_fill);
+        }
+        stats_.primitives_drawn += shape_primitives(d.style);
+    }
+
+    void Figure::draw_band(const FillBetweenData& d)
+    {
+        /* at most four outline points per pixel column and edge, whatever the sample count */
+        const double sx = plot_width() / (axes_.xmax - axes_.xmin);
+        const double sy = plot_height() / (axes_.ymax - axes_.ymin);
+        auto to_px = [&](double x, double y)
+            {
+                return PixelPoint{ kMarginLeft + (x - axes_.xmin) * sx, height_ - kMarginBottom - (y - axes_.ymin) * sy };
+            };
+        band_outline(d.x, d.y_lo, d.y_hi, to_px, band_scratch_);
+        band_px_.clear();
+        for (const PixelPoint& p : band_scratch_)
+            band_px_.emplace_back(static_cast<int>(std::lround(clamp_px(p.x))), static_cast<int>(std::lround(clamp_px(p.y))));
+        if (band_px_.size() < 3) return;
+
+        const cv::Point* pts = band_px_.data();
+        const int npts = static_cast<int>(band_px_.size());
+        const int lt_fill = line_type(quality_, Prim::Fill);
+        if (d.style.fill_alpha > 0.0f && d.style.fill_alpha < 1.0f)
+        {
+            const cv::Rect roi = grow(cv::boundingRect(band_px_), 2) & cv::Rect(0, 0, canvas_.cols, canvas_.rows);
+            if (!roi.empty())
+            {
+                cv::Mat& tmp = blend_scratch(roi);
+                cv::fillPoly(tmp, &pts, &npts, 1, cv_color(d.style.fill_color), lt_fill);
+                blend_shape(tmp(roi), roi, d.style.fill_alpha);
             }
         }
+        else if (d.style.fill_alpha >= 1.0f)
+        {
+            cv::fillPoly(canvas_, &pts, &npts, 1, cv_color(d.style.fill_color), lt_fill);
+        }
+        if (d.style.thickness > 0.0f)
+        {
+            cv::polylines(canvas_, band_px_, true, cv_color(d.style.line_color),
+                static_cast<int>(d.style.thickness), line_type(quality_, Prim::Segment));
+        }
+        stats_.primitives_drawn += shape_primitives(d.style);
+    }
+
+    void Figure::draw_line_matrix(const LineMatrixData& d)
+    {
+        const size_t n = d.x.size();
+        if (n < 2 || d.channels < 1 || d.y.size() < n * static_cast<size_t>(d.channels)) return;
+
+        /* x -> pixel column once for every channel */
+        const double sx = plot_width() / (axes_.xmax - axes_.xmin);
+        const double sy = plot_height() / (axes_.ymax - axes_.ymin);
+        matrix_px_.resize(n);
+        for (size_t i = 0; i < n; ++i)
+            matrix_px_[i] = static_cast<int>(std::lround(clamp_px(kMarginLeft + (d.x[i] - axes_.xmin) * sx)));
 
-        /* 7) legend ----------------------------------------------------------- */
-        if (legend_on_)
+        const int th = std::max(1, static_cast<int>(d.thickness));
+        const int lt = line_type(quality_, Prim::Segment);
+        const double y0 = height_ - kMarginBottom + axes_.ymin * sy;
+        for (int k = 0; k < d.channels; ++k)
         {
-            std::vector<const PlotCommand*> items;
-            for (const auto& c : cmds_) if (!c.label.empty()) items.push_back(&c);
-            if (!items.empty())
+            /* runs of samples in one pixel column keep their first, lowest, highest and last
+               point, which covers the same pixels as the full run */
+            const Series y = d.channel(k);
+            const double* yp = y.data();
+            auto py = [&](size_t i) { return static_cast<int>(std::lround(clamp_px(y0 - (yp ? yp[i] : y[i]) * sy))); };
+            matrix_pts_.clear();
+            for (size_t i = 0; i < n;)
             {
-                int maxTextW = 0, textH = 0, bl = 0;
-                for (auto* pc : items)
+                const int col = matrix_px_[i];
+                const int first = py(i);
+                int lo = first, hi = first, last = first;
+                size_t j = i + 1;
+                for (; j < n && matrix_px_[j] == col; ++j)
+                {
+                    last = py(j);
+                    lo = std::min(lo, last);
+                    hi = std::max(hi, last);
+                }
+                matrix_pts_.emplace_back(col, first);
+                if (j - i > 1)
                 {
-                    auto sz = cv::getTextSize(pc->label, cv::FONT_HERSHEY_SIMPLEX, 0.4, 1, &bl);
-                    maxTextW = std::max(maxTextW, sz.width);
-                    textH = std::max(textH, sz.height + bl);
+                    if (lo != first) matrix_pts_.emplace_back(col, lo);
+                    if (hi != first) matrix_pts_.emplace_back(col, hi);
+                    matrix_pts_.emplace_back(col, last);
                 }
-                const int sw = 20;
-                const int lh = textH + 6;
-                const int boxW = sw + 8 + maxTextW + 10;
-                const int boxH = lh * static_cast<int>(items.size()) + 10;
+                i = j;
+            }
+            const Color c = d.channel_color(k);
+            cv::polylines(canvas_, matrix_pts_, false, cv_color(c), th, lt);
+        }
+        stats_.primitives_drawn += static_cast<size_t>(d.channels);
+    }
 
-                cv::Point anchor = legend_anchor(boxW, boxH);
+    uint64_t Figure::new_cache_id()
+    {
+        static std::atomic<uint64_t> next{ 1 };
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
 
-                cv::rectangle(canvas_, anchor, { anchor.x + boxW, anchor.y + boxH }, cv::Scalar(255, 255, 255), cv::FILLED, cv::LINE_AA);
-                cv::rectangle(canvas_, anchor, { anchor.x + boxW, anchor.y + boxH }, cv::Scalar(0, 0, 0), 1);
+    size_t Figure::draw_series_chunk(const PlotCommand& cmd, size_t begin, size_t stride, size_t max_items)
+    {
+        const cv::Scalar cvcol = cv_color(cmd.color);
+        size_t drawn = 0, visited = 0;
+        if (cmd.type == CmdType::Line)
+        {
+            const auto& X = cmd.line().x;
+            const auto& Y = cmd.line().y;
+            const size_t n = X.size();
+            if (n < 2 || begin >= n - 1) return n;
+            const int th = static_cast<int>(cmd.line().thickness);
+            const int lt = line_type(quality_, Prim::Segment);
+            const cv::Rect area = cull_rect(canvas_, th);
 
-                for (size_t i = 0; i < items.size(); ++i)
+            /* segments join samples begin, begin+stride, ... and always end on the last point */
+            size_t i = begin;
+            cv::Point2i p0 = data_to_pixel(X[i], Y[i]);
+            int code0 = outcode(p0, area);
+            while (i < n - 1 && visited < max_items)
+            {
+                const size_t j = std::min(i + stride, n - 1);
+                const cv::Point2i p1 = data_to_pixel(X[j], Y[j]);
+                const int code1 = outcode(p1, area);
+                if ((code0 & code1) == 0)   /* not trivially off-canvas */
                 {
-                    int y = anchor.y + 5 + static_cast<int>(i) * lh + lh / 2;
-                    const PlotCommand* pc = items[i];
-                    cv::Scalar col(pc->color.b, pc->color.g, pc->color.r);
-                    switch (pc->type)
-                    {
-                    case CmdType::Line:
-                        cv::line(canvas_, { anchor.x + 5, y }, { anchor.x + 5 + sw, y }, col, 2, cv::LINE_AA);
-                        break;
-                    case CmdType::Scatter:
-                    case CmdType::Circle:
-                        cv::circle(canvas_, { anchor.x + 5 + sw / 2, y }, 4, col, cv::FILLED, cv::LINE_AA);
-                        break;
-                    default:
-                        cv::rectangle(canvas_, { anchor.x + 5, y - 4 }, { anchor.x + 5 + sw, y + 4 }, col, cv::FILLED, cv::LINE_AA);
-                    }
-                    cv::putText(canvas_, pc->label, { anchor.x + 5 + sw + 8, y + 4 }, cv::FONT_HERSHEY_SIMPLEX, 0.4, cv::Scalar(0, 0, 0), 1, cv::LINE_AA);
+                    cv::line(canvas_, p0, p1, cvcol, th, lt);
+                    ++drawn;
                 }
+                p0 = p1; code0 = code1; i = j;
+                ++visited;
             }
+            stats_.primitives_drawn += drawn;
+            stats_.points_culled += visited - drawn;
+            return i >= n - 1 ? n : i;
         }
 
-        /* 8) title & labels --------------------------------------------------- */
-        if (!title_.empty())
+        const ScatterData& sd = cmd.scatter();
+        const auto& X = sd.x;
+        const auto& Y = sd.y;
+        const size_t n = X.size();
+        const int r = static_cast<int>(sd.marker_size);
+        size_t i = begin;
+        if (sd.color_index.empty() && sd.sizes.empty())
         {
-            cv::putText(canvas_, title_, { kMargin, kMargin / 2 }, cv::FONT_HERSHEY_SIMPLEX, 0.6, cv::Scalar(0, 0, 0), 1, cv::LINE_AA);
+            const int lt = line_type(quality_, Prim::Marker, r);
+            const cv::Rect area = cull_rect(canvas_, r);
+            for (; i < n && visited < max_items; i += stride, ++visited)
+            {
+                const cv::Point2i p = data_to_pixel(X[i], Y[i]);
+                if (outcode(p, area) != 0) continue;
+                cv::circle(canvas_, p, r, cvcol, cv::FILLED, lt);
+                ++drawn;
+            }
         }
-        if (!xlabel_.empty())
+        else
         {
-            cv::putText(canvas_, xlabel_, { width_ / 2 - 40, height_ - 10 }, cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 0, 0), 1, cv::LINE_AA);
+            /* per-point colors / sizes: one pass, colors resolved through a prebuilt LUT */
+            cv::Scalar lut[256];
+            scalar_lut(sd.cmap, format_, lut);
+            const bool per_color = sd.color_index.size() >= n;
+            const bool per_size = sd.sizes.size() >= n;
+            const int lt_fixed = line_type(quality_, Prim::Marker, r);
+            const cv::Rect area = cull_rect(canvas_, 0);
+            for (; i < n && visited < max_items; i += stride, ++visited)
+            {
+                const cv::Point2i p = data_to_pixel(X[i], Y[i]);
+                const int ri = per_size ? std::max(0, static_cast<int>(sd.sizes[i])) : r;
+                if (p.x + ri < area.x || p.x - ri >= area.x + area.width ||
+                    p.y + ri < area.y || p.y - ri >= area.y + area.height) continue;
+                const cv::Scalar& col = per_color ? lut[static_cast<int>(sd.color_index[i]) & 255] : cvcol;
+                cv::circle(canvas_, p, ri, col, cv::FILLED, per_size ? line_type(quality_, Prim::Marker, ri) : lt_fixed);
+                ++drawn;
+            }
         }
-        draw_ylabel();
-
-        dirty_ = false;
+        stats_.primitives_drawn += drawn;
+        stats_.points_culled += visited - drawn;
+        return std::min(i, n);
     }
 
-    void Figure::show(const std::string& window_name)
+    bool Figure::legend_layout(LegendLayout& lay)
     {
-        if (dirty_) render();
-        cv::imshow(window_name, canvas_);
-        cv::waitKey(1);
+        if (!legend_on_) return false;
+        lay.items.clear();
+        for (const auto& c : cmds_) if (!c.label.empty()) lay.items.push_back(&c);
+        if (lay.items.empty()) return false;
+
+        int maxTextW = 0, textH = 0, bl = 0;
+        for (auto* pc : lay.items)
+        {
+            auto sz = cv::getTextSize(scratch_text(pc->label), cv::FONT_HERSHEY_SIMPLEX, 0.4, 1, &bl);
+            maxTextW = std::max(maxTextW, sz.width);
+            textH = std::max(textH, sz.height + bl);
+        }
+        lay.swatch = 20;
+        lay.line_h = textH + 6;
+        lay.box_w = lay.swatch + 8 + maxTextW + 10;
+        lay.box_h = lay.line_h * static_cast<int>(lay.items.size()) + 10;
+        lay.anchor = legend_anchor(lay.box_w, lay.box_h);
+        return true;
     }
 
-    void Figure::save(const std::string& filename)
+    void Figure::draw_legend()
     {
-        if (dirty_) render();
-        cv::imwrite(filename, canvas_);
-    }
+        LegendLayout lay;
+        if (!legend_layout(lay)) return;
+        const cv::Point anchor = lay.anchor;
+        const int sw = lay.swatch;
 
+        cv::rectangle(canvas_, anchor, { anchor.x + lay.box_w, anchor.y + lay.box_h }, cv_color(Color::White()), cv::FILLED, line_type(quality_, Prim::AxisAligned));
+        cv::rectangle(canvas_, anchor, { anchor.x + lay.box_w, anchor.y + lay.box_h }, cv_color(Color::Black()), 1);
 
+        for (size_t i = 0; i < lay.items.size(); ++i)
+        {
+            int y = anchor.y + 5 + static_cast<int>(i) * lay.line_h + lay.line_h / 2;
+            const PlotCommand* pc = lay.items[i];
+            const cv::Scalar col = cv_color(pc->color);
+            switch (pc->type)
+            {
+            case CmdType::Line:
+            case CmdType::Segments:
+            case CmdType::LineMatrix:
+                cv::line(canvas_, { anchor.x + 5, y }, { anchor.x + 5 + sw, y }, col, 2, line_type(quality_, Prim::AxisAligned));
+                break;
+            case CmdType::Scatter:
+            case CmdType::Circle:
+                cv::circle(canvas_, { anchor.x + 5 + sw / 2, y }, 4, col, cv::FILLED, line_type(quality_, Prim::Marker, 4));
+                break;
+            default:
+                cv::rectangle(canvas_, { anchor.x + 5, y - 4 }, { anchor.x + 5 + sw, y + 4 }, col, cv::FILLED, line_type(quality_, Prim::AxisAligned));
+            }
+            cv::putText(canvas_, scratch_text(pc->label), { anchor.x + 5 + sw + 8, y + 4 }, cv::FONT_HERSHEY_SIMPLEX, 0.4, cv_color(Color::Black()), 1, line_type(quality_, Prim::Text));
+        }
+    }
 
+    void Figure::draw_labels()
+    {
+        if (!title_.empty())
+        {
+            cv::putText(canvas_, title_, { kMargin, kMargin / 2 }, cv::FONT_HERSHEY_SIMPLEX, 0.6, cv_color(Color::Black()), 1, line_type(quality_, Prim::Text));
+        }
+        if (!xlabel_.empty())
+        {
+            cv::putText(canvas_, xlabel_, { width_ / 2 - 40, height_ - 10 }, cv::FONT_HERSHEY_SIMPLEX, 0.5, cv_color(Color::Black()), 1, line_type(quality_, Prim::Text));
+        }
+        draw_ylabel();
+    }
 
     /* --------------------------------------------------------------------------
      *  Private helpers
@@ -478,14 +2030,55 @@ namespace mpocv
         return { px, py };
     }
 
-    cv::Scalar Figure::cv_color(const Color& c, float alpha)
+    cv::Scalar Figure::cv_color(const Color& c, float alpha) const
+    {
+        return format_scalar(format_, c, alpha);
+    }
+
+    cv::Scalar Figure::background() const
+    {
+        return format_ == CanvasFormat::BGRA8 ? cv::Scalar(0, 0, 0, 0) : format_scalar(format_, Color::White());
+    }
+
+    cv::Mat& Figure::blend_scratch(const cv::Rect& roi)
+    {
+        if (blend_scratch_.size() != canvas_.size() || blend_scratch_.type() != canvas_.type())
+            blend_scratch_.create(canvas_.size(), canvas_.type());
+        canvas_(roi).copyTo(blend_scratch_(roi));
+        return blend_scratch_;
+    }
+
+    void Figure::blend_shape(const cv::Mat& shape, const cv::Rect& roi, float alpha)
+    {
+        if (roi.size() == canvas_.size()) ++stats_.full_canvas_blends;
+        cv::Mat dst = canvas_(roi);
+        cv::addWeighted(shape, alpha, dst, 1.0 - alpha, 0.0, dst);
+    }
+
+    void Figure::layout_subplots()
     {
-        return cv::Scalar(c.b, c.g, c.r, static_cast<uchar>(alpha * 255));
+        for (int i = 0; i < static_cast<int>(subplots_.size()); ++i)
+        {
+            const cv::Rect roi = subplot_rect(i);
+            Figure& sp = subplots_[i];
+            if (sp.format_ != format_) sp.apply_format(format_);   /* e.g. cells adopted by replay() */
+            cv::Mat view = canvas_(roi);
+            if (view.data == sp.canvas_.data && roi.size() == sp.canvas_.size()) continue;
+            sp.canvas_ = view;
+            sp.width_ = roi.width;
+            sp.height_ = roi.height;
+            sp.dirty_ = true;
+        }
     }
 
-    void Figure::blend_shape(const cv::Mat& shape, float alpha)
+    cv::Rect Figure::subplot_rect(int i) const
     {
-        cv::addWeighted(shape, alpha, canvas_, 1.0 - alpha, 0.0, canvas_);
+        const int top = title_.empty() ? 0 : kMarginTop;
+        const int gridH = std::max(0, height_ - top);
+        const int r = i / sub_cols_, c = i % sub_cols_;
+        const int x0 = c * width_ / sub_cols_, x1 = (c + 1) * width_ / sub_cols_;
+        const int y0 = top + r * gridH / sub_rows_, y1 = top + (r + 1) * gridH / sub_rows_;
+        return { x0, y0, x1 - x0, y1 - y0 };
     }
 
     /* --------------------------------------------------------------------------
@@ -536,7 +2129,7 @@ namespace mpocv
 
     void Figure::draw_axes(const TickInfo& xt, const TickInfo& yt)
     {
-        const cv::Scalar black(0, 0, 0);
+        const cv::Scalar black = cv_color(Color::Black());
         const int font = cv::FONT_HERSHEY_SIMPLEX;
 
         cv::line(canvas_, { kMarginLeft, height_ - kMarginBottom }, { width_ - kMarginRight, height_ - kMarginBottom }, black, 1);
@@ -544,7 +2137,7 @@ namespace mpocv
         {
             cv::Point2i p = data_to_pixel(xt.locs[i], axes_.ymin);
             cv::line(canvas_, { p.x, p.y }, { p.x, p.y + kTickLen }, black, 1);
-            cv::putText(canvas_, xt.labels[i], { p.x - 10, p.y + 18 }, font, 0.4, black, 1, cv::LINE_AA);
+            cv::putText(canvas_, xt.labels[i], { p.x - 10, p.y + 18 }, font, 0.4, black, 1, line_type(quality_, Prim::Text));
         }
 
         cv::line(canvas_, { kMarginLeft, kMarginTop }, { kMarginLeft, height_ - kMarginBottom }, black, 1);
@@ -552,23 +2145,23 @@ namespace mpocv
         {
             cv::Point2i p = data_to_pixel(axes_.xmin, yt.locs[i]);
             cv::line(canvas_, { p.x - kTickLen, p.y }, { p.x, p.y }, black, 1);
-            cv::putText(canvas_, yt.labels[i], { p.x - 30, p.y + 4 }, font, 0.4, black, 1, cv::LINE_AA);
+            cv::putText(canvas_, yt.labels[i], { p.x - 30, p.y + 4 }, font, 0.4, black, 1, line_type(quality_, Prim::Text));
         }
     }
 
     void Figure::draw_grid(const TickInfo& xt, const TickInfo& yt)
     {
         if (!axes_.grid) return;
-        const cv::Scalar light(220, 220, 220);
+        const cv::Scalar light = cv_color(Color(220, 220, 220));
         for (double xv : xt.locs)
         {
             if (xv < axes_.xmin || xv > axes_.xmax) continue;
-            cv::line(canvas_, data_to_pixel(xv, axes_.ymin), data_to_pixel(xv, axes_.ymax), light, 1, cv::LINE_AA);
+            cv::line(canvas_, data_to_pixel(xv, axes_.ymin), data_to_pixel(xv, axes_.ymax), light, 1, line_type(quality_, Prim::AxisAligned));
         }
         for (double yv : yt.locs)
         {
             if (yv < axes_.ymin || yv > axes_.ymax) continue;
-            cv::line(canvas_, data_to_pixel(axes_.xmin, yv), data_to_pixel(axes_.xmax, yv), light, 1, cv::LINE_AA);
+            cv::line(canvas_, data_to_pixel(axes_.xmin, yv), data_to_pixel(axes_.xmax, yv), light, 1, line_type(quality_, Prim::AxisAligned));
         }
     }
 
@@ -579,8 +2172,8 @@ namespace mpocv
         {
             int baseline = 0;
             auto sz = cv::getTextSize(ylabel_, cv::FONT_HERSHEY_SIMPLEX, 0.5, 1, &baseline);
-            cv::Mat txt(sz.height + baseline, sz.width, CV_8UC3, cv::Scalar(255, 255, 255));
-            cv::putText(txt, ylabel_, { 0, sz.height }, cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 0, 0), 1, cv::LINE_AA);
+            cv::Mat txt(sz.height + baseline, sz.width, canvas_.type(), background());
+            cv::putText(txt, ylabel_, { 0, sz.height }, cv::FONT_HERSHEY_SIMPLEX, 0.5, cv_color(Color::Black()), 1, cv::LINE_AA);
             cv::rotate(txt, ylabel_cache_, cv::ROTATE_90_COUNTERCLOCKWISE);
             ylabel_cache_valid_ = true;
         }
@@ -592,10 +2185,10 @@ namespace mpocv
         }
     }
 
-    cv::Point2i Figure::anchored_text_pos(const TextData& td) const
+    cv::Point2i Figure::anchored_text_pos(const TextData& td, const std::string& text) const
     {
         int bl = 0;
-        const auto sz = cv::getTextSize(td.text, cv::FONT_HERSHEY_SIMPLEX,
+        const auto sz = cv::getTextSize(text, cv::FONT_HERSHEY_SIMPLEX,
             td.font_scale, td.thickness, &bl);
         cv::Point2i p = data_to_pixel(td.x, td.y);
 
@@ -623,9 +2216,99 @@ namespace mpocv
         ensure_nonzero_span(a.ymin, a.ymax);
     }
 
-    void Figure::expand_bounds(const std::vector<double>& xs, const std::vector<double>& ys)
+    void Figure::expand_bounds(const Series& xs, const Series& ys)
+    {
+        const size_t n = std::min(xs.size(), ys.size());
+        const double* x = xs.data();
+        const double* y = ys.data();
+        if (x && y)
+        {
+            for (size_t i = 0; i < n; ++i) data_bounds_.expand(x[i], y[i]);
+        }
+        else
+        {
+            for (size_t i = 0; i < n; ++i) data_bounds_.expand(xs[i], ys[i]);
+        }
+    }
+
+    void Figure::expand_bounds(const PlotCommand& cmd)
+    {
+        switch (cmd.type)
+        {
+        case CmdType::Line:    expand_bounds(cmd.line().x, cmd.line().y); break;
+        case CmdType::Scatter: expand_bounds(cmd.scatter().x, cmd.scatter().y); break;
+        case CmdType::Polygon: expand_bounds(cmd.polygon().x, cmd.polygon().y); break;
+        case CmdType::Text:    break;   /* annotations do not drive autoscale */
+        case CmdType::Circle:
+        {
+            const auto& d = cmd.circle();
+            data_bounds_.expand(d.cx - d.radius, d.cy - d.radius);
+            data_bounds_.expand(d.cx + d.radius, d.cy + d.radius);
+            break;
+        }
+        case CmdType::RectXYWH:
+        case CmdType::RectLTRB:
+            data_bounds_.expand(cmd.rect().x0, cmd.rect().y0);
+            data_bounds_.expand(cmd.rect().x1, cmd.rect().y1);
+            break;
+        case CmdType::RotatedRect:
+        {
+            const auto& d = cmd.rot_rect();
+            const double r = 0.5 * std::sqrt(d.width * d.width + d.height * d.height);
+            data_bounds_.expand(d.cx - r, d.cy - r);
+            data_bounds_.expand(d.cx + r, d.cy + r);
+            break;
+        }
+        case CmdType::Ellipse:
+        {
+            const auto& d = cmd.ellipse();
+            data_bounds_.expand(d.cx - 0.5 * d.width, d.cy - 0.5 * d.height);
+            data_bounds_.expand(d.cx + 0.5 * d.width, d.cy + 0.5 * d.height);
+            break;
+        }
+        case CmdType::Image:
+            data_bounds_.expand(cmd.image().x0, cmd.image().y0);
+            data_bounds_.expand(cmd.image().x1, cmd.image().y1);
+            break;
+        case CmdType::Segments:
+        {
+            const auto& d = cmd.segments();
+            const size_t n = std::min(d.x.size(), d.y.size());
+            for (size_t i = 0; i < n; ++i) data_bounds_.expand(d.ox + d.sx * d.x[i], d.oy + d.sy * d.y[i]);
+            break;
+        }
+        case CmdType::FillBetween:
+            expand_bounds(cmd.band().x, cmd.band().y_lo);
+            expand_bounds(cmd.band().x, cmd.band().y_hi);
+            break;
+        case CmdType::LineMatrix:
+        {
+            /* one pass over x and one over all channels, instead of x once per channel */
+            double xlo, xhi, ylo, yhi;
+            if (!finite_min_max(cmd.matrix().x, xlo, xhi) || !finite_min_max(cmd.matrix().y, ylo, yhi)) break;
+            data_bounds_.expand(xlo, ylo);
+            data_bounds_.expand(xhi, yhi);
+            break;
+        }
+        case CmdType::Histogram:
+        {
+            /* the extent of the autoscaled bins: the sample range, from 0 to the tallest bar */
+            double lo, hi;
+            if (!hist_range(cmd.hist(), lo, hi)) break;
+            const auto& counts = hist_counts(cmd.hist(), lo, hi);
+            data_bounds_.expand(lo, 0.0);
+            data_bounds_.expand(hi, static_cast<double>(*std::max_element(counts.begin(), counts.end())));
+            break;
+        }
+        }
+    }
+
+    void Figure::resolve_pending_bounds()
     {
-        for (size_t i = 0; i < xs.size(); ++i) data_bounds_.expand(xs[i], ys[i]);
+        if (bounds_pending_from_ == kNoPendingBounds) return;
+        /* expanding is idempotent, so eager commands past the mark may be visited again */
+        for (size_t i = bounds_pending_from_; i < cmds_.size(); ++i) expand_bounds(cmds_[i]);
+        bounds_pending_from_ = kNoPendingBounds;
     }
 
     cv::Point Figure::legend_anchor(int boxW, int boxH) const
@@ -0,0 +1,106 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#include "histogram.h"
+
+#include <opencv2/core.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace mpocv
+{
+    namespace
+    {
+        constexpr size_t kMinChunk = size_t(1) << 16;   ///< Samples per parallel chunk, at least.
+
+        /// Number of chunks to split @p n samples into (a few per thread for balance).
+        size_t chunk_count(size_t n)
+        {
+            const size_t per_threads = static_cast<size_t>(std::max(1, cv::getNumThreads())) * 4;
+            return std::max<size_t>(1, std::min(per_threads, n / kMinChunk));
+        }
+
+        /// Calls f(begin, end, chunk) for every chunk of [0, n), in parallel.
+        template<typename F>
+        void for_chunks(size_t n, size_t chunks, F&& f)
+        {
+            cv::parallel_for_(cv::Range(0, static_cast<int>(chunks)), [&](const cv::Range& r)
+                {
+                    for (int i = r.start; i < r.end; ++i)
+                    {
+                        const size_t k = static_cast<size_t>(i);
+                        f(n * k / chunks, n * (k + 1) / chunks, k);
+                    }
+                });
+        }
+
+        /// Bins samples [begin, end) through @p at (index -> value).
+        template<typename At>
+        void bin_range(At&& at, size_t begin, size_t end, double lo, double hi, size_t bins, uint64_t* counts)
+        {
+            const double scale = static_cast<double>(bins) / (hi - lo);
+            const size_t last = bins - 1;
+            for (size_t i = begin; i < end; ++i)
+            {
+                const double v = at(i);
+                if (!(v >= lo && v <= hi)) continue;   /* also rejects NaN */
+                ++counts[std::min(static_cast<size_t>((v - lo) * scale), last)];
+            }
+        }
+    } // namespace
+
+    bool finite_min_max(const Series& s, double& lo, double& hi)
+    {
+        const size_t n = s.size();
+        const size_t chunks = chunk_count(n);
+        std::vector<double> los(chunks, std::numeric_limits<double>::infinity());
+        std::vector<double> his(chunks, -std::numeric_limits<double>::infinity());
+        const double* p = s.data();
+        for_chunks(n, chunks, [&](size_t b, size_t e, size_t k)
+            {
+                double l = los[k], h = his[k];
+                for (size_t i = b; i < e; ++i)
+                {
+                    const double v = p ? p[i] : s[i];
+                    if (!std::isfinite(v)) continue;
+                    l = std::min(l, v);
+                    h = std::max(h, v);
+                }
+                los[k] = l; his[k] = h;
+            });
+        lo = *std::min_element(los.begin(), los.end());
+        hi = *std::max_element(his.begin(), his.end());
+        return lo <= hi;
+    }
+
+    void histogram_counts(const Series& s, double lo, double hi, size_t bins, std::vector<uint64_t>& counts)
+    {
+        counts.assign(bins, 0);
+        if (bins == 0 || !(hi > lo)) return;
+
+        const size_t n = s.size();
+        const size_t chunks = chunk_count(n);
+        std::vector<uint64_t> partial(chunks * bins, 0);   /* one private histogram per chunk */
+        const double* p = s.data();
+        for_chunks(n, chunks, [&](size_t b, size_t e, size_t k)
+            {
+                uint64_t* own = partial.data() + k * bins;
+                if (p) bin_range([p](size_t i) { return p[i]; }, b, e, lo, hi, bins, own);
+                else   bin_range([&s](size_t i) { return s[i]; }, b, e, lo, hi, bins, own);
+            });
+
+        for (size_t k = 0; k < chunks; ++k)
+        {
+            const uint64_t* own = partial.data() + k * bins;
+            for (size_t i = 0; i < bins; ++i) counts[i] += own[i];
+        }
+    }
+
+} // namespace mpocv
@@ -0,0 +1,186 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+// Interactive zoom / pan viewer.
+//
+// The mouse callback only queues events; they are applied on the loop in
+// interact(), between cv::waitKey() calls. Every change restarts a Draft
+// render_progressive() sequence, and each frame finishes at least its first
+// pass (subsampled to about kCoarsePoints, off-canvas geometry culled) before
+// it is shown, so a drag never waits for the full data. Once input has been
+// idle for a moment the quality is raised to Final and the remaining passes
+// run within a per-frame budget, so events are still picked up while refining.
+
+#include "figure.h"
+#include "trace.h"
+
+#include <chrono>
+
+namespace mpocv
+{
+    namespace
+    {
+        constexpr double kZoomStep = 1.25;       ///< Limits scale per wheel notch.
+        constexpr double kIdleMs = 250.0;        ///< Input pause before refining at full quality.
+        constexpr double kFrameBudgetMs = 15.0;  ///< Render time per loop iteration while refining.
+        constexpr int    kPollMs = 15;           ///< cv::waitKey() timeout while there is nothing to draw.
+
+        struct MouseEvent
+        {
+            int event, x, y, flags;
+        };
+
+        /// Queues an event for interact(); moves without the left button are of no interest.
+        void on_mouse(int event, int x, int y, int flags, void* user)
+        {
+            if (event == cv::EVENT_MOUSEMOVE && !(flags & cv::EVENT_FLAG_LBUTTON)) return;
+            static_cast<std::vector<MouseEvent>*>(user)->push_back({ event, x, y, flags });
+        }
+    } // namespace
+
+    void Figure::interact(const std::string& window_name)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        /* limits to reset to: this figure first, then each cell */
+        std::vector<Axes> initial{ axes_ };
+        for (const auto& sp : subplots_) initial.push_back(sp.axes_);
+        const RenderQuality entry_quality = quality_;
+
+        std::vector<MouseEvent> events;
+        cv::namedWindow(window_name, cv::WINDOW_AUTOSIZE);
+        cv::setMouseCallback(window_name, on_mouse, &events);
+        render();
+        cv::imshow(window_name, canvas_);
+
+        Figure* drag_target = nullptr;
+        cv::Point drag_start;
+        Axes drag_axes;
+        auto last_input = Clock::now();
+        bool refined = false;
+
+        for (;;)
+        {
+            const int key = cv::waitKey(needs_render() ? 1 : kPollMs);
+            if (key == 27 || key == 'q') break;
+            if (cv::getWindowProperty(window_name, cv::WND_PROP_VISIBLE) < 1.0) break;
+
+            bool changed = false;
+            bool reset = key == 'r';
+            for (const MouseEvent& e : events)
+            {
+                cv::Point p(e.x, e.y);
+                switch (e.event)
+                {
+                case cv::EVENT_MOUSEWHEEL:
+                {
+                    const int delta = cv::getMouseWheelDelta(e.flags);
+                    if (delta == 0) break;
+                    figure_at(p).zoom_about(p, delta > 0 ? 1.0 / kZoomStep : kZoomStep);
+                    changed = true;
+                    break;
+                }
+                case cv::EVENT_LBUTTONDOWN:
+                    drag_start = p;
+                    drag_target = &figure_at(p);
+                    drag_axes = drag_target->axes_;
+                    break;
+                case cv::EVENT_MOUSEMOVE:
+                    if (!drag_target) break;
+                    drag_target->pan_from(drag_axes, e.x - drag_start.x, e.y - drag_start.y);
+                    changed = true;
+                    break;
+                case cv::EVENT_LBUTTONUP:
+                    drag_target = nullptr;
+                    break;
+                case cv::EVENT_RBUTTONDOWN:
+                case cv::EVENT_LBUTTONDBLCLK:
+                    reset = true;
+                    break;
+                default:
+                    break;
+                }
+            }
+            events.clear();
+
+            if (reset)
+            {
+                axes_ = initial[0];
+                dirty_ = true;
+                for (size_t i = 0; i < subplots_.size() && i + 1 < initial.size(); ++i)
+                {
+                    subplots_[i].axes_ = initial[i + 1];
+                    subplots_[i].dirty_ = true;
+                }
+                drag_target = nullptr;
+                changed = true;
+            }
+
+            drain_feeds();   /* producer data counts as a change of the frame too */
+            const auto now = Clock::now();
+            if (changed)
+            {
+                last_input = now;
+                refined = false;
+                render_quality(RenderQuality::Draft);
+            }
+            else if (!refined && std::chrono::duration<double, std::milli>(now - last_input).count() > kIdleMs)
+            {
+                refined = true;
+                render_quality(RenderQuality::Final);
+            }
+
+            if (!needs_render()) continue;
+            MPOCV_TRACE_SCOPE("interact_frame");
+            RenderProgress p = render_progressive(kFrameBudgetMs);
+            while (!p.complete && p.pass == 0) p = render_progressive(kFrameBudgetMs);   /* never show a stale frame */
+            cv::imshow(window_name, canvas_);
+        }
+
+        cv::setMouseCallback(window_name, nullptr, nullptr);
+        render_quality(entry_quality);
+    }
+
+    Figure& Figure::figure_at(cv::Point& p)
+    {
+        for (int i = 0; i < static_cast<int>(subplots_.size()); ++i)
+        {
+            const cv::Rect roi = subplot_rect(i);
+            if (!roi.contains(p)) continue;
+            p -= roi.tl();
+            return subplots_[i].figure_at(p);
+        }
+        return *this;
+    }
+
+    void Figure::zoom_about(const cv::Point& p, double factor)
+    {
+        /* the data point under the cursor stays under the cursor */
+        const double cx = axes_.xmin + (p.x - kMarginLeft) * (axes_.xmax - axes_.xmin) / plot_width();
+        const double cy = axes_.ymin + (height_ - kMarginBottom - p.y) * (axes_.ymax - axes_.ymin) / plot_height();
+        set_xlim(cx - (cx - axes_.xmin) * factor, cx + (axes_.xmax - cx) * factor);
+        set_ylim(cy - (cy - axes_.ymin) * factor, cy + (axes_.ymax - cy) * factor);
+    }
+
+    void Figure::pan_from(const Axes& from, int dx, int dy)
+    {
+        const double ux = dx * (from.xmax - from.xmin) / plot_width();
+        const double uy = dy * (from.ymax - from.ymin) / plot_height();
+        set_xlim(from.xmin - ux, from.xmax - ux);
+        set_ylim(from.ymin + uy, from.ymax + uy);
+    }
+
+    bool Figure::needs_render() const
+    {
+        if (dirty_ || prog_.active) return true;
+        for (const auto& sp : subplots_)
+            if (sp.needs_render()) return true;
+        return false;
+    }
+
+} // namespace mpocv
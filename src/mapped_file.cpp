@@ -0,0 +1,96 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mpocv
+{
+
+#ifdef _WIN32
+
+    std::shared_ptr<const MappedFile> MappedFile::open(const std::string& filename)
+    {
+        HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return nullptr;
+
+        LARGE_INTEGER len{};
+        if (!GetFileSizeEx(file, &len) || len.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return nullptr;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);   /* the mapping keeps the file open */
+        if (!mapping) return nullptr;
+
+        void* addr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!addr)
+        {
+            CloseHandle(mapping);
+            return nullptr;
+        }
+
+        std::shared_ptr<MappedFile> m(new MappedFile());
+        m->addr_ = addr;
+        m->size_ = static_cast<size_t>(len.QuadPart);
+        m->mapping_ = mapping;
+        return m;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (addr_) UnmapViewOfFile(addr_);
+        if (mapping_) CloseHandle(mapping_);
+    }
+
+#else
+
+    std::shared_ptr<const MappedFile> MappedFile::open(const std::string& filename)
+    {
+        const int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return nullptr;
+
+        struct stat st {};
+        if (fstat(fd, &st) != 0 || st.st_size <= 0)
+        {
+            ::close(fd);
+            return nullptr;
+        }
+
+        void* addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);   /* the mapping keeps the file open */
+        if (addr == MAP_FAILED) return nullptr;
+
+        std::shared_ptr<MappedFile> m(new MappedFile());
+        m->addr_ = addr;
+        m->size_ = static_cast<size_t>(st.st_size);
+        return m;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (addr_) munmap(addr_, size_);
+    }
+
+#endif
+
+} // namespace mpocv
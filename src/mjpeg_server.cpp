@@ -0,0 +1,334 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+// MJPEG-over-HTTP streaming: MjpegServer and Figure::stream_mjpeg().
+//
+// The rendering thread encodes a frame once and publishes it by swapping a
+// shared pointer. Each client thread waits for a newer sequence number, takes
+// whatever frame is newest at that moment and sends it with blocking writes,
+// so a slow client only ever delays itself and simply skips frames.
+
+#include "figure.h"
+#include "mjpeg_server.h"
+#include "trace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace mpocv
+{
+    namespace
+    {
+#ifdef _WIN32
+        using socket_t = SOCKET;
+        constexpr int kSendFlags = 0;
+
+        bool net_init()
+        {
+            static const bool ok = [] { WSADATA d; return WSAStartup(MAKEWORD(2, 2), &d) == 0; }();
+            return ok;
+        }
+        void close_socket(socket_t s) { closesocket(s); }
+        void shutdown_socket(socket_t s) { shutdown(s, SD_BOTH); }
+
+        bool wait_readable(socket_t s, int ms)
+        {
+            fd_set set;
+            FD_ZERO(&set);
+            FD_SET(s, &set);
+            timeval tv{ 0, ms * 1000 };
+            return select(0, &set, nullptr, nullptr, &tv) > 0;
+        }
+#else
+        using socket_t = int;
+#ifdef MSG_NOSIGNAL
+        constexpr int kSendFlags = MSG_NOSIGNAL;   /* a vanished client must not raise SIGPIPE */
+#else
+        constexpr int kSendFlags = 0;              /* SO_NOSIGPIPE is set per socket instead */
+#endif
+
+        bool net_init() { return true; }
+        void close_socket(socket_t s) { close(s); }
+        void shutdown_socket(socket_t s) { shutdown(s, SHUT_RDWR); }
+
+        /* poll(), not select(): the descriptor may be above FD_SETSIZE in a busy process */
+        bool wait_readable(socket_t s, int ms)
+        {
+            pollfd p{ s, POLLIN, 0 };
+            return poll(&p, 1, ms) > 0 && (p.revents & POLLIN) != 0;
+        }
+#endif
+
+        constexpr intptr_t kNoSocket = -1;
+        constexpr size_t   kPoolSize = 4;      ///< Recycled frame buffers.
+        constexpr int      kPollMs = 100;      ///< Accept loop wake-up for stop().
+        constexpr size_t   kMaxRequest = 8192; ///< Bytes of request head read before streaming.
+
+        socket_t to_socket(intptr_t s) { return static_cast<socket_t>(s); }
+
+        bool send_all(intptr_t sock, const void* data, size_t n)
+        {
+            const char* p = static_cast<const char*>(data);
+            while (n > 0)
+            {
+                const int chunk = static_cast<int>(std::min<size_t>(n, 1 << 20));
+                const auto sent = send(to_socket(sock), p, chunk, kSendFlags);
+                if (sent <= 0) return false;
+                p += sent;
+                n -= static_cast<size_t>(sent);
+            }
+            return true;
+        }
+
+        bool send_all(intptr_t sock, const char* text)
+        {
+            return send_all(sock, text, std::strlen(text));
+        }
+
+        const char kStreamHeader[] =
+            "HTTP/1.0 200 OK\r\n"
+            "Server: mpocv\r\n"
+            "Connection: close\r\n"
+            "Cache-Control: no-cache, no-store\r\n"
+            "Pragma: no-cache\r\n"
+            "Content-Type: multipart/x-mixed-replace; boundary=mpocvframe\r\n"
+            "\r\n";
+    } // namespace
+
+    /* --------------------------------------------------------------------------
+     *  MjpegServer
+     * ------------------------------------------------------------------------*/
+    MjpegServer::~MjpegServer()
+    {
+        stop();
+    }
+
+    bool MjpegServer::start(int port, const std::string& bind_addr, int max_clients)
+    {
+        if (running_.load() || !net_init()) return false;
+
+        const socket_t s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (static_cast<intptr_t>(s) == kNoSocket) return false;
+
+        int one = 1;
+        setsockopt(s, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&one), sizeof(one));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        if (inet_pton(AF_INET, bind_addr.c_str(), &addr.sin_addr) != 1 ||
+            bind(s, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            listen(s, 8) != 0)
+        {
+            close_socket(s);
+            return false;
+        }
+        socklen_t len = sizeof(addr);
+        getsockname(s, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+
+        listen_sock_ = static_cast<intptr_t>(s);
+        max_clients_ = std::max(1, max_clients);
+        running_.store(true);
+        acceptor_ = std::thread(&MjpegServer::accept_loop, this);
+        return true;
+    }
+
+    void MjpegServer::stop()
+    {
+        if (!running_.exchange(false)) return;
+        if (acceptor_.joinable()) acceptor_.join();   /* notices running_ within kPollMs */
+        close_socket(to_socket(listen_sock_));
+        listen_sock_ = kNoSocket;
+
+        /* unblock clients stuck in send() or recv(), and those waiting for a frame */
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            for (auto& c : conns_)
+                if (c->sock != kNoSocket) shutdown_socket(to_socket(c->sock));
+        }
+        frame_cv_.notify_all();
+        reap_clients(true);
+
+        std::lock_guard<std::mutex> lk(mtx_);
+        latest_.reset();
+    }
+
+    MjpegServer::Frame MjpegServer::acquire()
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        for (const Frame& f : pool_)
+        {
+            /* clients drop their references under mtx_ too, so a count of 1 is exact */
+            if (f.use_count() != 1) continue;   /* still the latest frame or being sent */
+            f->clear();
+            return f;
+        }
+        Frame f = std::make_shared<std::vector<uint8_t>>();
+        if (pool_.size() < kPoolSize) pool_.push_back(f);
+        return f;
+    }
+
+    void MjpegServer::publish(Frame jpeg)
+    {
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            latest_ = std::move(jpeg);
+            ++seq_;
+        }
+        frame_cv_.notify_all();
+    }
+
+    void MjpegServer::accept_loop()
+    {
+        const socket_t ls = to_socket(listen_sock_);
+        while (running_.load())
+        {
+            const bool ready = wait_readable(ls, kPollMs);
+            reap_clients(false);
+            if (!ready) continue;
+
+            const socket_t cs = accept(ls, nullptr, nullptr);
+            if (static_cast<intptr_t>(cs) == kNoSocket) continue;
+            if (clients_.load() >= max_clients_)
+            {
+                close_socket(cs);
+                continue;
+            }
+            int one = 1;
+            setsockopt(cs, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&one), sizeof(one));
+#ifdef SO_NOSIGPIPE
+            setsockopt(cs, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+
+            auto client = std::make_unique<Client>();
+            client->sock = static_cast<intptr_t>(cs);
+            Client& c = *client;
+            {
+                std::lock_guard<std::mutex> lk(mtx_);
+                conns_.push_back(std::move(client));
+            }
+            ++clients_;
+            c.thread = std::thread(&MjpegServer::serve, this, std::ref(c));
+        }
+    }
+
+    void MjpegServer::serve(Client& c)
+    {
+        /* the request itself does not matter: read its head, then stream */
+        char buf[1024];
+        size_t got = 0, matched = 0;
+        const char* end = "\r\n\r\n";
+        while (matched < 4 && got < kMaxRequest)
+        {
+            const auto n = recv(to_socket(c.sock), buf, sizeof(buf), 0);
+            if (n <= 0) break;
+            for (int i = 0; i < n && matched < 4; ++i) matched = buf[i] == end[matched] ? matched + 1 : (buf[i] == '\r' ? 1 : 0);
+            got += static_cast<size_t>(n);
+        }
+
+        Frame f;
+        if (matched == 4 && send_all(c.sock, kStreamHeader))
+        {
+            uint64_t seen = 0;
+            char part[128];
+            for (;;)
+            {
+                {
+                    std::unique_lock<std::mutex> lk(mtx_);
+                    frame_cv_.wait(lk, [&] { return !running_.load() || seq_ != seen; });
+                    if (!running_.load()) break;
+                    f = latest_;   /* releases the frame just sent */
+                    seen = seq_;
+                }
+                if (!f) continue;
+                std::snprintf(part, sizeof(part), "--mpocvframe\r\nContent-Type: image/jpeg\r\nContent-Length: %zu\r\n\r\n", f->size());
+                if (!send_all(c.sock, part) || !send_all(c.sock, f->data(), f->size()) || !send_all(c.sock, "\r\n")) break;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            f.reset();
+            close_socket(to_socket(c.sock));
+            c.sock = kNoSocket;
+        }
+        --clients_;
+        c.done.store(true);
+    }
+
+    void MjpegServer::reap_clients(bool all)
+    {
+        /* joined outside the lock: a finishing client still takes it once */
+        std::vector<std::unique_ptr<Client>> finished;
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            for (auto it = conns_.begin(); it != conns_.end();)
+            {
+                if (all || (*it)->done.load()) { finished.push_back(std::move(*it)); it = conns_.erase(it); }
+                else ++it;
+            }
+        }
+        for (auto& c : finished)
+            if (c->thread.joinable()) c->thread.join();
+    }
+
+    /* --------------------------------------------------------------------------
+     *  Figure streaming
+     * ------------------------------------------------------------------------*/
+    bool Figure::stream_mjpeg(int port, double max_fps, int jpeg_quality, const std::string& bind_addr)
+    {
+        stop_stream();
+        auto server = std::make_unique<MjpegServer>();
+        if (!server->start(port, bind_addr)) return false;
+        mjpeg_ = std::move(server);
+        mjpeg_interval_s_ = max_fps > 0.0 ? 1.0 / max_fps : 0.0;
+        mjpeg_quality_ = std::max(0, std::min(100, jpeg_quality));
+        mjpeg_last_ns_ = 0;
+        mjpeg_sent_seq_ = frame_seq_ - 1;   /* the current canvas is still to be sent */
+        return true;
+    }
+
+    void Figure::stop_stream()
+    {
+        mjpeg_.reset();
+    }
+
+    void Figure::publish_mjpeg()
+    {
+        if (!mjpeg_ || mjpeg_sent_seq_ == frame_seq_ || mjpeg_->clients() == 0) return;
+
+        const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        if (mjpeg_last_ns_ != 0 && (now - mjpeg_last_ns_) * 1e-9 < mjpeg_interval_s_) return;
+
+        MPOCV_TRACE_SCOPE("mjpeg_encode");
+        MjpegServer::Frame f = mjpeg_->acquire();
+        if (!cv::imencode(".jpg", encodable(".jpg"), *f, { cv::IMWRITE_JPEG_QUALITY, mjpeg_quality_ })) return;
+        mjpeg_->publish(std::move(f));
+        mjpeg_last_ns_ = now;
+        mjpeg_sent_seq_ = frame_seq_;
+    }
+
+} // namespace mpocv
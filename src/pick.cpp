@@ -0,0 +1,237 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+// Hit-testing: Figure::pick() and its lazily built spatial index.
+//
+// Series points are stored in a SpatialGrid in data space under a 64-bit key
+// (command index << kIndexBits | sample index). The grid is laid out over the
+// data bounds when first needed and then only appended to; it is rebuilt when
+// the indexed point count has grown kRegrow times past its layout, which keeps
+// appends amortized O(1) while cells stay small. Commands dropped from the
+// front by a memory budget only advance pick_dropped_, the offset between a
+// key's command and the current index; their keys are skipped until the next
+// rebuild sweeps them out. A pick converts the pixel
+// radius to a data-space rectangle per axis, visits the overlapping cells and
+// measures candidates in pixels, so anisotropic scales are handled exactly.
+
+#include "figure.h"
+#include "trace.h"
+
+namespace mpocv
+{
+    namespace
+    {
+        constexpr unsigned kIndexBits = 40;   ///< Sample index bits of a key (the rest is the command).
+        constexpr uint64_t kIndexMask = (uint64_t(1) << kIndexBits) - 1;
+        constexpr size_t   kRegrow = 4;       ///< Rebuild once the points outgrow the layout this much.
+        constexpr uint64_t kCommandKeys = uint64_t(1) << (64 - kIndexBits);   ///< Distinct command keys.
+
+        uint64_t pick_key(size_t cmd, size_t index)
+        {
+            return static_cast<uint64_t>(cmd) << kIndexBits | (static_cast<uint64_t>(index) & kIndexMask);
+        }
+
+        /// Number of points a command adds to the grid (0 for shapes matched by box).
+        size_t indexed_points(const PlotCommand& c)
+        {
+            switch (c.type)
+            {
+            case CmdType::Line:       return std::min(c.line().x.size(), c.line().y.size());
+            case CmdType::Scatter:    return std::min(c.scatter().x.size(), c.scatter().y.size());
+            case CmdType::Polygon:    return std::min(c.polygon().x.size(), c.polygon().y.size());
+            case CmdType::Segments:   return std::min(c.segments().x.size(), c.segments().y.size());
+            case CmdType::LineMatrix: return std::min(c.matrix().y.size(), c.matrix().x.size() * static_cast<size_t>(std::max(0, c.matrix().channels)));
+            default:                  return 0;
+            }
+        }
+
+        /// Data position of point @p i of a series command (see indexed_points()).
+        void point_at(const PlotCommand& c, size_t i, double& x, double& y)
+        {
+            switch (c.type)
+            {
+            case CmdType::Line:     x = c.line().x[i];    y = c.line().y[i];    break;
+            case CmdType::Scatter:  x = c.scatter().x[i]; y = c.scatter().y[i]; break;
+            case CmdType::Polygon:  x = c.polygon().x[i]; y = c.polygon().y[i]; break;
+            case CmdType::Segments:
+                x = c.segments().ox + c.segments().sx * c.segments().x[i];
+                y = c.segments().oy + c.segments().sy * c.segments().y[i];
+                break;
+            case CmdType::LineMatrix:
+                x = c.matrix().x[i % c.matrix().x.size()];
+                y = c.matrix().y[i];
+                break;
+            default:
+                x = y = 0.0;
+            }
+        }
+    } // namespace
+
+    PickResult Figure::pick(int px, int py, double radius)
+    {
+        if (!subplots_.empty())
+        {
+            for (int i = 0; i < static_cast<int>(subplots_.size()); ++i)
+            {
+                const cv::Rect roi = subplot_rect(i);
+                if (!roi.contains(cv::Point(px, py))) continue;
+                PickResult r = subplots_[i].pick(px - roi.x, py - roi.y, radius);
+                r.subplot = i;
+                return r;
+            }
+            return PickResult{};
+        }
+        if (cmds_.empty() || !(radius >= 0.0)) return PickResult{};
+
+        MPOCV_TRACE_SCOPE("pick");
+        if (dirty_) update_limits();
+        update_pick_index();
+
+        const double sx = plot_width() / (axes_.xmax - axes_.xmin);
+        const double sy = plot_height() / (axes_.ymax - axes_.ymin);
+        const double cx = axes_.xmin + (px - kMarginLeft) / sx;
+        const double cy = axes_.ymin + (height_ - kMarginBottom - py) / sy;
+
+        PickResult best;
+        best.distance = radius;
+        pick_grid_.query(cx - radius / sx, cx + radius / sx, cy - radius / sy, cy + radius / sy, [&](uint64_t key)
+            {
+                const size_t keyed = static_cast<size_t>(key >> kIndexBits);
+                if (keyed < pick_dropped_) return;   /* dropped by the memory budget */
+                const size_t cmd = keyed - pick_dropped_;
+                const size_t index = static_cast<size_t>(key & kIndexMask);
+                double x, y;
+                point_at(cmds_[cmd], index, x, y);
+                const double d = std::hypot((x - cx) * sx, (y - cy) * sy);
+                /* ties go to the later (topmost) command */
+                if (d < best.distance || (d == best.distance && (!best.found || cmd > best.command)))
+                {
+                    best.found = true;
+                    best.command = cmd; best.index = index;
+                    best.x = x; best.y = y;
+                    best.distance = d;
+                }
+            });
+        if (best.found) return best;
+
+        /* no point in range: the topmost shape whose box is within the radius */
+        for (auto it = pick_shapes_.rbegin(); it != pick_shapes_.rend(); ++it)
+        {
+            const Bounds& b = it->box;
+            const double dx = std::max({ b.xmin - cx, 0.0, cx - b.xmax }) * sx;
+            const double dy = std::max({ b.ymin - cy, 0.0, cy - b.ymax }) * sy;
+            const double d = std::hypot(dx, dy);
+            if (d > radius || (best.found && d >= best.distance)) continue;
+            best.found = true;
+            best.command = it->cmd - pick_dropped_; best.index = 0;
+            best.x = cx; best.y = cy;
+            best.distance = d;
+        }
+        return best;
+    }
+
+    void Figure::update_pick_index()
+    {
+        if (pick_indexed_ > cmds_.size()) reset_pick_index();
+        if (pick_indexed_ == cmds_.size()) return;
+
+        size_t incoming = 0;
+        for (size_t i = pick_indexed_; i < cmds_.size(); ++i) incoming += indexed_points(cmds_[i]);
+
+        if (pick_indexed_ == 0 || pick_grid_.size() + incoming > kRegrow * pick_sized_for_)
+        {
+            /* (re)lay out the grid over the current data and index everything */
+            MPOCV_TRACE_SCOPE("pick_index_build");
+            resolve_pending_bounds();
+            size_t total = 0;
+            for (const auto& c : cmds_) total += indexed_points(c);
+            const Bounds& b = data_bounds_;
+            if (b.valid()) pick_grid_.reset(b.xmin, b.xmax, b.ymin, b.ymax, total);
+            else           pick_grid_.reset(0.0, 1.0, 0.0, 1.0, total);
+            pick_shapes_.clear();
+            pick_indexed_ = 0;
+            pick_sized_for_ = std::max<size_t>(total, 1);
+            pick_dropped_ = 0;
+        }
+
+        for (size_t i = pick_indexed_; i < cmds_.size(); ++i)
+        {
+            const PlotCommand& c = cmds_[i];
+            const size_t n = indexed_points(c);
+            if (n > 0)
+            {
+                double x, y;
+                for (size_t k = 0; k < n; ++k)
+                {
+                    point_at(c, k, x, y);
+                    pick_grid_.insert(x, y, pick_key(i + pick_dropped_, k));
+                }
+            }
+            else if (c.type != CmdType::Text)
+            {
+                const Bounds box = command_box(c);
+                if (box.valid()) pick_shapes_.push_back({ i + pick_dropped_, box });
+            }
+        }
+        pick_indexed_ = cmds_.size();
+    }
+
+    void Figure::reset_pick_index()
+    {
+        pick_grid_ = SpatialGrid{};
+        pick_shapes_.clear();
+        pick_indexed_ = 0;
+        pick_sized_for_ = 0;
+        pick_dropped_ = 0;
+    }
+
+    void Figure::drop_from_pick_index(size_t n)
+    {
+        if (n == 0) return;
+        if (n >= pick_indexed_ || pick_dropped_ + n + cmds_.size() + 1 >= kCommandKeys)
+        {
+            reset_pick_index();
+            return;
+        }
+        pick_dropped_ += n;
+        pick_indexed_ -= n;
+        const auto kept = std::find_if(pick_shapes_.begin(), pick_shapes_.end(),
+            [this](const PickShape& s) { return s.cmd >= pick_dropped_; });
+        pick_shapes_.erase(pick_shapes_.begin(), kept);
+    }
+
+    void Figure::index_appended_points(size_t cmd, size_t from)
+    {
+        if (cmd >= pick_indexed_) return;   /* indexed with everything else on the next pick() */
+        const PlotCommand& c = cmds_[cmd];
+        const size_t n = indexed_points(c);
+        if (pick_grid_.size() + (n - from) > kRegrow * pick_sized_for_)
+        {
+            reset_pick_index();   /* outgrown: lay out again on the next pick() */
+            return;
+        }
+        double x, y;
+        for (size_t k = from; k < n; ++k)
+        {
+            point_at(c, k, x, y);
+            pick_grid_.insert(x, y, pick_key(cmd + pick_dropped_, k));
+        }
+    }
+
+    Bounds Figure::command_box(const PlotCommand& cmd)
+    {
+        /* expand_bounds() knows every command's extent; run it against empty bounds */
+        const Bounds saved = data_bounds_;
+        data_bounds_ = Bounds{};
+        expand_bounds(cmd);
+        const Bounds box = data_bounds_;
+        data_bounds_ = saved;
+        return box;
+    }
+
+} // namespace mpocv
@@ -0,0 +1,507 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+// Binary record / replay of a Figure's command stream.
+//
+// Layout (native byte order, checked through the endian tag):
+//
+//   File     := Header Section
+//   Header   := "MPOCVREC" | u32 version | u32 endian_tag | u32 reserved[2]
+//   Section  := Settings | u32 n_cmds | Command[n_cmds]
+//               | u32 sub_rows | u32 sub_cols | Section[sub_rows * sub_cols]
+//   Settings := f64 xmin xmax ymin ymax pad_frac | u8 autoscale equal_scale grid legend_on
+//               | str title xlabel ylabel legend_loc | f64 bounds xmin xmax ymin ymax
+//   Command  := u32 type | u8 r g b pad | str label | type-specific fields
+//               (scatter, version >= 2: ... series x y | u8 cmap | series color_index sizes)
+//               (image, version >= 3: u32 rows cols | f64 x0 y0 x1 y1 vmin vmax
+//                | u8 cmap interp | series values)
+//               (segments, version >= 4: f32 thickness | f64 ox oy sx sy | u8 cmap
+//                | series x y color_index)
+//               (histogram, version >= 5: i32 bins | style | series data)
+//               (fill_between, version >= 6: style | series x y_lo y_hi)
+//               (line_matrix, version >= 7: i32 channels | f32 thickness | u8 cmap | series x y)
+//   str      := u32 length | bytes
+//   series   := u64 count | u8 sample_type | zero padding to a 64-byte file offset
+//               | sample[count]           (f64, f32 or u8 as tagged by sample_type)
+//               (version < 8: u64 count | padding | f64[count])
+//
+// Series are stored raw in their own sample type and 64-byte aligned, so
+// replay maps the file and hands typed Series views straight to the
+// commands: no parsing, widening or copying of point data, and pages are
+// only read when something touches them.
+
+#include "figure.h"
+#include "mapped_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace mpocv
+{
+    namespace
+    {
+        constexpr char     kMagic[8] = { 'M', 'P', 'O', 'C', 'V', 'R', 'E', 'C' };
+        constexpr uint32_t kVersion = 8;   ///< 2: per-point scatter colors / sizes, 3: images, 4: segments, 5: histograms, 6: bands, 7: line matrices, 8: typed series
+        constexpr uint32_t kEndianTag = 0x01020304u;
+        constexpr size_t   kSeriesAlign = 64;
+    } // namespace
+
+    /* --------------------------------------------------------------------------
+     *  Stream helpers
+     * ------------------------------------------------------------------------*/
+    class RecordWriter
+    {
+    public:
+        explicit RecordWriter(const std::string& filename)
+            : os_(filename, std::ios::binary)
+        {}
+
+        bool ok() const { return static_cast<bool>(os_); }
+
+        template<typename T>
+        void pod(const T& v)
+        {
+            os_.write(reinterpret_cast<const char*>(&v), sizeof(T));
+            pos_ += sizeof(T);
+        }
+
+        void bytes(const void* p, size_t n)
+        {
+            os_.write(static_cast<const char*>(p), static_cast<std::streamsize>(n));
+            pos_ += n;
+        }
+
+        template<typename S>
+        void str(const S& s)
+        {
+            pod(static_cast<uint32_t>(s.size()));
+            bytes(s.data(), s.size());
+        }
+
+        void color(const Color& c)
+        {
+            pod(c.r); pod(c.g); pod(c.b);
+        }
+
+        void style(const ShapeStyle& s)
+        {
+            color(s.line_color);
+            color(s.fill_color);
+            pod(s.thickness);
+            pod(s.fill_alpha);
+        }
+
+        void series(const Series& s)
+        {
+            pod(static_cast<uint64_t>(s.size()));
+            pod(static_cast<uint8_t>(s.type()));
+            static const char zeros[kSeriesAlign] = {};
+            bytes(zeros, (kSeriesAlign - pos_ % kSeriesAlign) % kSeriesAlign);
+
+            const size_t elem = Series::sample_size(s.type());
+            if (s.stride() == elem)
+            {
+                bytes(s.raw_data(), s.size() * elem);
+                return;
+            }
+            /* strided view (e.g. one column of an interleaved file): pack through a small buffer */
+            unsigned char buf[8192];
+            const unsigned char* src = static_cast<const unsigned char*>(s.raw_data());
+            const size_t per_chunk = sizeof(buf) / elem;
+            for (size_t i = 0; i < s.size(); i += per_chunk)
+            {
+                const size_t n = std::min(per_chunk, s.size() - i);
+                for (size_t k = 0; k < n; ++k) std::memcpy(buf + k * elem, src + (i + k) * s.stride(), elem);
+                bytes(buf, n * elem);
+            }
+        }
+
+    private:
+        std::ofstream os_;
+        uint64_t      pos_{ 0 };
+    };
+
+    class RecordReader
+    {
+    public:
+        explicit RecordReader(std::shared_ptr<const MappedFile> file)
+            : file_(std::move(file))
+        {}
+
+        bool ok() const { return ok_; }
+
+        /// Format version of the file (valid after header()).
+        uint32_t version() const { return version_; }
+
+        template<typename T>
+        T pod()
+        {
+            T v{};
+            if (!need(sizeof(T))) return v;
+            std::memcpy(&v, file_->data() + pos_, sizeof(T));
+            pos_ += sizeof(T);
+            return v;
+        }
+
+        std::string str()
+        {
+            const uint32_t n = pod<uint32_t>();
+            if (!need(n)) return {};
+            std::string s(reinterpret_cast<const char*>(file_->data() + pos_), n);
+            pos_ += n;
+            return s;
+        }
+
+        Color color()
+        {
+            Color c;
+            c.r = pod<uint8_t>(); c.g = pod<uint8_t>(); c.b = pod<uint8_t>();
+            return c;
+        }
+
+        ShapeStyle style()
+        {
+            ShapeStyle s;
+            s.line_color = color();
+            s.fill_color = color();
+            s.thickness = pod<float>();
+            s.fill_alpha = pod<float>();
+            return s;
+        }
+
+        /// Typed view into the mapping; keeps the mapping alive.
+        Series series()
+        {
+            const uint64_t n = pod<uint64_t>();
+            const uint8_t tag = version_ >= 8 ? pod<uint8_t>() : static_cast<uint8_t>(SampleType::Float64);
+            if (tag > static_cast<uint8_t>(SampleType::UInt8)) { ok_ = false; return {}; }
+            const SampleType type = static_cast<SampleType>(tag);
+            const size_t elem = Series::sample_size(type);
+
+            if (!need((kSeriesAlign - pos_ % kSeriesAlign) % kSeriesAlign)) return {};
+            pos_ += (kSeriesAlign - pos_ % kSeriesAlign) % kSeriesAlign;
+            if (n > (file_->size() - pos_) / elem) { ok_ = false; return {}; }
+            const void* p = file_->data() + pos_;
+            pos_ += static_cast<size_t>(n) * elem;
+            return Series::view(p, static_cast<size_t>(n), type, elem, file_);
+        }
+
+        bool header()
+        {
+            if (!need(sizeof(kMagic)) || std::memcmp(file_->data(), kMagic, sizeof(kMagic)) != 0) return ok_ = false;
+            pos_ += sizeof(kMagic);
+            version_ = pod<uint32_t>();
+            const uint32_t endian = pod<uint32_t>();
+            pod<uint32_t>(); pod<uint32_t>();
+            return ok_ = ok_ && version_ >= 1 && version_ <= kVersion && endian == kEndianTag;
+        }
+
+    private:
+        bool need(size_t n)
+        {
+            if (!ok_ || n > file_->size() - pos_) ok_ = false;
+            return ok_;
+        }
+
+        std::shared_ptr<const MappedFile> file_;
+        size_t   pos_{ 0 };
+        uint32_t version_{ 0 };
+        bool     ok_{ true };
+    };
+
+    /* --------------------------------------------------------------------------
+     *  Figure record / replay
+     * ------------------------------------------------------------------------*/
+    bool Figure::record(const std::string& filename)
+    {
+        RecordWriter out(filename);
+        if (!out.ok()) return false;
+
+        out.bytes(kMagic, sizeof(kMagic));
+        out.pod(kVersion);
+        out.pod(kEndianTag);
+        out.pod(uint32_t{ 0 }); out.pod(uint32_t{ 0 });
+        write_section(out);
+        return out.ok();
+    }
+
+    bool Figure::replay(const std::string& filename)
+    {
+        auto file = MappedFile::open(filename);
+        if (!file) return false;
+
+        RecordReader in(file);
+        if (!in.header()) return false;
+
+        /* parse into a scratch figure so a corrupt file leaves this one untouched */
+        Figure staged(width_, height_, mr_);
+        if (!staged.read_section(in)) return false;
+
+        axes_ = staged.axes_;
+        title_ = std::move(staged.title_);
+        xlabel_ = std::move(staged.xlabel_);
+        ylabel_ = std::move(staged.ylabel_);
+        legend_on_ = staged.legend_on_;
+        legend_loc_ = std::move(staged.legend_loc_);
+        data_bounds_ = staged.data_bounds_;
+        bounds_pending_from_ = kNoPendingBounds;
+        cmds_ = std::move(staged.cmds_);
+        cmd_bytes_ = staged.cmd_bytes_;
+        reset_pick_index();
+        subplots_ = std::move(staged.subplots_);
+        sub_rows_ = staged.sub_rows_;
+        sub_cols_ = staged.sub_cols_;
+        layout_subplots();
+
+        ylabel_cache_valid_ = false;
+        dirty_ = true;
+        if (mem_policy_ != MemoryPolicy::Throw) enforce_budget(0);
+        return true;
+    }
+
+    void Figure::write_section(RecordWriter& out)
+    {
+        resolve_pending_bounds();
+
+        out.pod(axes_.xmin); out.pod(axes_.xmax);
+        out.pod(axes_.ymin); out.pod(axes_.ymax);
+        out.pod(axes_.pad_frac);
+        out.pod(static_cast<uint8_t>(axes_.autoscale));
+        out.pod(static_cast<uint8_t>(axes_.equal_scale));
+        out.pod(static_cast<uint8_t>(axes_.grid));
+        out.pod(static_cast<uint8_t>(legend_on_));
+        out.str(title_); out.str(xlabel_); out.str(ylabel_); out.str(legend_loc_);
+        out.pod(data_bounds_.xmin); out.pod(data_bounds_.xmax);
+        out.pod(data_bounds_.ymin); out.pod(data_bounds_.ymax);
+
+        out.pod(static_cast<uint32_t>(cmds_.size()));
+        for (const auto& c : cmds_)
+        {
+            out.pod(static_cast<uint32_t>(c.type));
+            out.color(c.color);
+            out.pod(uint8_t{ 0 });
+            out.str(c.label);
+            switch (c.type)
+            {
+            case CmdType::Line:
+                out.pod(c.line().thickness);
+                out.series(c.line().x); out.series(c.line().y);
+                break;
+            case CmdType::Scatter:
+                out.pod(c.scatter().marker_size);
+                out.series(c.scatter().x); out.series(c.scatter().y);
+                out.pod(static_cast<uint8_t>(c.scatter().cmap));
+                out.series(c.scatter().color_index); out.series(c.scatter().sizes);
+                break;
+            case CmdType::Text:
+                out.pod(c.txt().x); out.pod(c.txt().y);
+                out.pod(c.txt().font_scale);
+                out.pod(static_cast<int32_t>(c.txt().thickness));
+                out.pod(static_cast<uint8_t>(c.txt().halign));
+                out.pod(static_cast<uint8_t>(c.txt().valign));
+                out.str(c.txt().text);
+                break;
+            case CmdType::Circle:
+                out.pod(c.circle().cx); out.pod(c.circle().cy); out.pod(c.circle().radius);
+                out.style(c.circle().style);
+                break;
+            case CmdType::RectLTRB:
+            case CmdType::RectXYWH:
+                out.pod(c.rect().x0); out.pod(c.rect().y0); out.pod(c.rect().x1); out.pod(c.rect().y1);
+                out.style(c.rect().style);
+                break;
+            case CmdType::RotatedRect:
+                out.pod(c.rot_rect().cx); out.pod(c.rot_rect().cy);
+                out.pod(c.rot_rect().width); out.pod(c.rot_rect().height); out.pod(c.rot_rect().angle_deg);
+                out.style(c.rot_rect().style);
+                break;
+            case CmdType::Polygon:
+                out.style(c.polygon().style);
+                out.series(c.polygon().x); out.series(c.polygon().y);
+                break;
+            case CmdType::Ellipse:
+                out.pod(c.ellipse().cx); out.pod(c.ellipse().cy);
+                out.pod(c.ellipse().width); out.pod(c.ellipse().height); out.pod(c.ellipse().angle_deg);
+                out.style(c.ellipse().style);
+                break;
+            case CmdType::Image:
+                out.pod(static_cast<uint32_t>(c.image().rows)); out.pod(static_cast<uint32_t>(c.image().cols));
+                out.pod(c.image().x0); out.pod(c.image().y0); out.pod(c.image().x1); out.pod(c.image().y1);
+                out.pod(c.image().vmin); out.pod(c.image().vmax);
+                out.pod(static_cast<uint8_t>(c.image().cmap)); out.pod(static_cast<uint8_t>(c.image().interp));
+                out.series(c.image().values);
+                break;
+            case CmdType::Segments:
+                out.pod(c.segments().thickness);
+                out.pod(c.segments().ox); out.pod(c.segments().oy); out.pod(c.segments().sx); out.pod(c.segments().sy);
+                out.pod(static_cast<uint8_t>(c.segments().cmap));
+                out.series(c.segments().x); out.series(c.segments().y); out.series(c.segments().color_index);
+                break;
+            case CmdType::Histogram:
+                out.pod(static_cast<int32_t>(c.hist().bins));
+                out.style(c.hist().style);
+                out.series(c.hist().data);
+                break;
+            case CmdType::FillBetween:
+                out.style(c.band().style);
+                out.series(c.band().x); out.series(c.band().y_lo); out.series(c.band().y_hi);
+                break;
+            case CmdType::LineMatrix:
+                out.pod(static_cast<int32_t>(c.matrix().channels));
+                out.pod(c.matrix().thickness);
+                out.pod(static_cast<uint8_t>(c.matrix().cmap));
+                out.series(c.matrix().x); out.series(c.matrix().y);
+                break;
+            }
+        }
+
+        out.pod(static_cast<uint32_t>(sub_rows_));
+        out.pod(static_cast<uint32_t>(sub_cols_));
+        for (auto& sp : subplots_) sp.write_section(out);
+    }
+
+    bool Figure::read_section(RecordReader& in)
+    {
+        axes_.xmin = in.pod<double>(); axes_.xmax = in.pod<double>();
+        axes_.ymin = in.pod<double>(); axes_.ymax = in.pod<double>();
+        axes_.pad_frac = in.pod<double>();
+        axes_.autoscale = in.pod<uint8_t>() != 0;
+        axes_.equal_scale = in.pod<uint8_t>() != 0;
+        axes_.grid = in.pod<uint8_t>() != 0;
+        legend_on_ = in.pod<uint8_t>() != 0;
+        title_ = in.str(); xlabel_ = in.str(); ylabel_ = in.str(); legend_loc_ = in.str();
+        data_bounds_.xmin = in.pod<double>(); data_bounds_.xmax = in.pod<double>();
+        data_bounds_.ymin = in.pod<double>(); data_bounds_.ymax = in.pod<double>();
+
+        const uint32_t n = in.pod<uint32_t>();
+        for (uint32_t i = 0; i < n && in.ok(); ++i)
+        {
+            const uint32_t type = in.pod<uint32_t>();
+            if (type >= kCmdTypeCount) return false;
+            PlotCommand c(static_cast<CmdType>(type), mr_);
+            c.color = in.color();
+            in.pod<uint8_t>();
+            c.label = in.str();
+            switch (c.type)
+            {
+            case CmdType::Line:
+                c.line().thickness = in.pod<float>();
+                c.line().x = in.series(); c.line().y = in.series();
+                break;
+            case CmdType::Scatter:
+                c.scatter().marker_size = in.pod<float>();
+                c.scatter().x = in.series(); c.scatter().y = in.series();
+                if (in.version() >= 2)
+                {
+                    c.scatter().cmap = static_cast<Colormap>(std::min<uint8_t>(in.pod<uint8_t>(), static_cast<uint8_t>(Colormap::Tab10)));
+                    c.scatter().color_index = in.series(); c.scatter().sizes = in.series();
+                }
+                break;
+            case CmdType::Text:
+                c.txt().x = in.pod<double>(); c.txt().y = in.pod<double>();
+                c.txt().font_scale = in.pod<double>();
+                c.txt().thickness = in.pod<int32_t>();
+                c.txt().halign = static_cast<TextData::HAlign>(std::min<uint8_t>(in.pod<uint8_t>(), 2));
+                c.txt().valign = static_cast<TextData::VAlign>(std::min<uint8_t>(in.pod<uint8_t>(), 3));
+                c.txt().text = in.str();
+                break;
+            case CmdType::Circle:
+                c.circle().cx = in.pod<double>(); c.circle().cy = in.pod<double>(); c.circle().radius = in.pod<double>();
+                c.circle().style = in.style();
+                break;
+            case CmdType::RectLTRB:
+            case CmdType::RectXYWH:
+                c.rect().x0 = in.pod<double>(); c.rect().y0 = in.pod<double>();
+                c.rect().x1 = in.pod<double>(); c.rect().y1 = in.pod<double>();
+                c.rect().style = in.style();
+                break;
+            case CmdType::RotatedRect:
+                c.rot_rect().cx = in.pod<double>(); c.rot_rect().cy = in.pod<double>();
+                c.rot_rect().width = in.pod<double>(); c.rot_rect().height = in.pod<double>();
+                c.rot_rect().angle_deg = in.pod<double>();
+                c.rot_rect().style = in.style();
+                break;
+            case CmdType::Polygon:
+                c.polygon().style = in.style();
+                c.polygon().x = in.series(); c.polygon().y = in.series();
+                break;
+            case CmdType::Ellipse:
+                c.ellipse().cx = in.pod<double>(); c.ellipse().cy = in.pod<double>();
+                c.ellipse().width = in.pod<double>(); c.ellipse().height = in.pod<double>();
+                c.ellipse().angle_deg = in.pod<double>();
+                c.ellipse().style = in.style();
+                break;
+            case CmdType::Image:
+            {
+                ImageData& d = c.image();
+                d.rows = static_cast<int>(std::min<uint32_t>(in.pod<uint32_t>(), 1u << 30));
+                d.cols = static_cast<int>(std::min<uint32_t>(in.pod<uint32_t>(), 1u << 30));
+                d.x0 = in.pod<double>(); d.y0 = in.pod<double>(); d.x1 = in.pod<double>(); d.y1 = in.pod<double>();
+                d.vmin = in.pod<double>(); d.vmax = in.pod<double>();
+                d.cmap = static_cast<Colormap>(std::min<uint8_t>(in.pod<uint8_t>(), static_cast<uint8_t>(Colormap::Tab10)));
+                d.interp = static_cast<ImageInterp>(std::min<uint8_t>(in.pod<uint8_t>(), 1));
+                d.values = in.series();
+                if (d.values.size() != static_cast<size_t>(d.rows) * static_cast<size_t>(d.cols)) return false;
+                d.id = new_cache_id();
+                break;
+            }
+            case CmdType::Segments:
+            {
+                SegmentData& d = c.segments();
+                d.thickness = in.pod<float>();
+                d.ox = in.pod<double>(); d.oy = in.pod<double>(); d.sx = in.pod<double>(); d.sy = in.pod<double>();
+                d.cmap = static_cast<Colormap>(std::min<uint8_t>(in.pod<uint8_t>(), static_cast<uint8_t>(Colormap::Tab10)));
+                d.x = in.series(); d.y = in.series(); d.color_index = in.series();
+                break;
+            }
+            case CmdType::Histogram:
+            {
+                HistData& d = c.hist();
+                d.bins = in.pod<int32_t>();
+                d.style = in.style();
+                d.data = in.series();
+                if (d.bins < 1 || d.bins > (1 << 24)) return false;
+                d.id = new_cache_id();
+                break;
+            }
+            case CmdType::FillBetween:
+                c.band().style = in.style();
+                c.band().x = in.series(); c.band().y_lo = in.series(); c.band().y_hi = in.series();
+                break;
+            case CmdType::LineMatrix:
+            {
+                LineMatrixData& d = c.matrix();
+                d.channels = in.pod<int32_t>();
+                d.thickness = in.pod<float>();
+                d.cmap = static_cast<Colormap>(std::min<uint8_t>(in.pod<uint8_t>(), static_cast<uint8_t>(Colormap::Tab10)));
+                d.x = in.series(); d.y = in.series();
+                if (d.channels < 1 || d.y.size() != d.x.size() * static_cast<size_t>(d.channels)) return false;
+                break;
+            }
+            }
+            if (!in.ok()) return false;
+
+            /* bounds come from the recording: no pass over (possibly unmapped) points */
+            adopt_command(std::move(c));
+        }
+
+        const uint32_t rows = in.pod<uint32_t>();
+        const uint32_t cols = in.pod<uint32_t>();
+        if (!in.ok() || rows > 1024 || cols > 1024) return false;
+        if (rows > 0 && cols > 0)
+        {
+            subplot(static_cast<int>(rows), static_cast<int>(cols), 1);
+            for (auto& sp : subplots_)
+                if (!sp.read_section(in)) return false;
+        }
+
+        return in.ok();
+    }
+
+} // namespace mpocv
@@ -0,0 +1,131 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#include "series_io.h"
+#include "mapped_file.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace mpocv
+{
+    namespace
+    {
+        bool host_little_endian()
+        {
+            const uint16_t probe = 1;
+            unsigned char first;
+            std::memcpy(&first, &probe, 1);
+            return first == 1;
+        }
+
+        /// Text following @p key (a quoted dict key) in an .npy header, or npos.
+        size_t find_value(const std::string& header, const char* key)
+        {
+            size_t p = header.find(key);
+            if (p == std::string::npos) return p;
+            p = header.find(':', p);
+            if (p == std::string::npos) return p;
+            p = header.find_first_not_of(" \t", p + 1);
+            return p;
+        }
+
+        /**
+         * Parse the dict of an .npy header. Only the three keys NumPy always
+         * writes are read; anything outside float32/float64 is rejected.
+         */
+        bool parse_npy_header(const std::string& h, SampleType& type, bool& fortran,
+            std::vector<size_t>& shape)
+        {
+            size_t p = find_value(h, "'descr'");
+            if (p == std::string::npos || h.size() < p + 5) return false;
+            const std::string descr = h.substr(p + 1, 3);   /* skip the quote */
+            if (descr == "<f8")      type = SampleType::Float64;
+            else if (descr == "<f4") type = SampleType::Float32;
+            else return false;
+
+            p = find_value(h, "'fortran_order'");
+            if (p == std::string::npos) return false;
+            fortran = h.compare(p, 4, "True") == 0;
+
+            p = find_value(h, "'shape'");
+            if (p == std::string::npos || h[p] != '(') return false;
+            const size_t end = h.find(')', p);
+            if (end == std::string::npos) return false;
+            for (size_t i = p + 1; i < end; )
+            {
+                i = h.find_first_of("0123456789", i);
+                if (i == std::string::npos || i >= end) break;
+                size_t v = 0;
+                for (; i < end && h[i] >= '0' && h[i] <= '9'; ++i) v = v * 10 + static_cast<size_t>(h[i] - '0');
+                shape.push_back(v);
+            }
+            return shape.size() == 1 || shape.size() == 2;
+        }
+    } // namespace
+
+    Series load_npy(const std::string& filename, size_t column)
+    {
+        if (!host_little_endian()) return {};
+        auto file = MappedFile::open(filename);
+        if (!file || file->size() < 10) return {};
+
+        const unsigned char* d = file->data();
+        if (std::memcmp(d, "\x93NUMPY", 6) != 0) return {};
+        const unsigned major = d[6];
+
+        size_t header_len = 0, data_off = 0;
+        if (major == 1)
+        {
+            header_len = d[8] | (d[9] << 8);
+            data_off = 10 + header_len;
+        }
+        else if (major == 2 || major == 3)
+        {
+            if (file->size() < 12) return {};
+            header_len = static_cast<size_t>(d[8]) | (static_cast<size_t>(d[9]) << 8)
+                | (static_cast<size_t>(d[10]) << 16) | (static_cast<size_t>(d[11]) << 24);
+            data_off = 12 + header_len;
+        }
+        else return {};
+        if (data_off > file->size()) return {};
+
+        SampleType type;
+        bool fortran = false;
+        std::vector<size_t> shape;
+        const std::string header(reinterpret_cast<const char*>(d) + (data_off - header_len), header_len);
+        if (!parse_npy_header(header, type, fortran, shape)) return {};
+
+        const size_t rows = shape[0];
+        const size_t cols = shape.size() == 2 ? shape[1] : 1;
+        if (column >= cols) return {};
+
+        const size_t item = Series::sample_size(type);
+        if (cols != 0 && rows > (file->size() - data_off) / item / cols) return {};   /* truncated */
+
+        /* C order: samples of a column are cols apart; Fortran order: columns are contiguous */
+        const size_t stride = fortran ? item : item * cols;
+        const size_t start = data_off + (fortran ? column * rows * item : column * item);
+        return Series::view(d + start, rows, type, stride, file);
+    }
+
+    Series load_raw(const std::string& filename, SampleType type,
+        size_t channels, size_t channel, size_t offset)
+    {
+        if (!host_little_endian() || channels == 0 || channel >= channels) return {};
+        auto file = MappedFile::open(filename);
+        if (!file || offset >= file->size()) return {};
+
+        const size_t frame = Series::sample_size(type) * channels;
+        const size_t n = (file->size() - offset) / frame;
+        if (n == 0) return {};
+        return Series::view(file->data() + offset + channel * Series::sample_size(type), n, type, frame, file);
+    }
+
+} // namespace mpocv
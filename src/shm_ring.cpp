@@ -0,0 +1,276 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+// Shared-memory frame ring: layout, ShmPublisher / ShmReader and
+// Figure::publish_shm().
+//
+// Segment layout (all blocks 64-byte aligned):
+//   RingHeader | SlotHeader 0 | pixels 0 | SlotHeader 1 | pixels 1 | ...
+// A slot's seq is odd while the publisher writes it. The reader copies the
+// slot header and pixels between two loads of seq and keeps the copy only if
+// both loads returned the same even value.
+
+#include "figure.h"
+#include "shm_ring.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mpocv
+{
+    namespace
+    {
+        constexpr char     kMagic[8] = { 'M', 'P', 'O', 'C', 'V', 'R', 'N', 'G' };
+        constexpr uint32_t kLayoutVersion = 1;
+        constexpr int      kReadAttempts = 4;
+
+        static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory seqlock needs lock-free 64-bit atomics");
+
+        struct alignas(64) RingHeader
+        {
+            char     magic[8];
+            uint32_t version;
+            uint32_t slots;
+            uint64_t slot_bytes;               ///< Pixel capacity of one slot.
+            std::atomic<uint64_t> frames;      ///< Published frames; the newest is in slot (frames - 1) % slots.
+        };
+
+        struct alignas(64) SlotHeader
+        {
+            std::atomic<uint64_t> seq;         ///< Odd while the slot is being written.
+            uint64_t frame;                    ///< Frame number (1-based).
+            int64_t  time_ns;                  ///< steady_clock time of publish().
+            int32_t  rows, cols, type;         ///< cv::Mat geometry of the pixels.
+        };
+
+        constexpr size_t align64(size_t n) { return (n + 63) & ~size_t(63); }
+
+        size_t slot_stride(uint64_t slot_bytes) { return sizeof(SlotHeader) + align64(static_cast<size_t>(slot_bytes)); }
+
+        SlotHeader* slot_at(void* base, const RingHeader& h, uint64_t i)
+        {
+            return reinterpret_cast<SlotHeader*>(static_cast<char*>(base) + sizeof(RingHeader) + i * slot_stride(h.slot_bytes));
+        }
+
+        std::string shm_name(const std::string& name)
+        {
+            return !name.empty() && name[0] == '/' ? name : "/" + name;
+        }
+    } // namespace
+
+#ifndef _WIN32
+
+    /* --------------------------------------------------------------------------
+     *  ShmPublisher
+     * ------------------------------------------------------------------------*/
+    std::unique_ptr<ShmPublisher> ShmPublisher::create(const std::string& name, size_t slot_bytes, int slots)
+    {
+        const std::string path = shm_name(name);
+        const uint32_t n = static_cast<uint32_t>(std::max(2, slots));
+        const size_t size = sizeof(RingHeader) + n * slot_stride(slot_bytes);
+
+        shm_unlink(path.c_str());   /* a stale ring of a crashed run may have another size */
+        const int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) return nullptr;
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+        {
+            close(fd);
+            shm_unlink(path.c_str());
+            return nullptr;
+        }
+        void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (base == MAP_FAILED)
+        {
+            shm_unlink(path.c_str());
+            return nullptr;
+        }
+
+        /* ftruncate zero-fills: every seq starts even (0) and frames at 0 */
+        RingHeader* h = new (base) RingHeader;
+        h->version = kLayoutVersion;
+        h->slots = n;
+        h->slot_bytes = slot_bytes;
+        h->frames.store(0, std::memory_order_relaxed);
+        for (uint32_t i = 0; i < n; ++i) new (slot_at(base, *h, i)) SlotHeader{};
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(h->magic, kMagic, sizeof(kMagic));   /* readers accept the ring from here on */
+
+        std::unique_ptr<ShmPublisher> p(new ShmPublisher);
+        p->name_ = path;
+        p->base_ = base;
+        p->size_ = size;
+        return p;
+    }
+
+    ShmPublisher::~ShmPublisher()
+    {
+        munmap(base_, size_);
+        shm_unlink(name_.c_str());
+    }
+
+    bool ShmPublisher::publish(const cv::Mat& frame)
+    {
+        RingHeader& h = *static_cast<RingHeader*>(base_);
+        const size_t row = frame.cols * frame.elemSize();
+        if (frame.empty() || row * frame.rows > h.slot_bytes) return false;
+
+        const uint64_t n = h.frames.load(std::memory_order_relaxed) + 1;
+        SlotHeader& s = *slot_at(base_, h, (n - 1) % h.slots);
+        char* px = reinterpret_cast<char*>(&s) + sizeof(SlotHeader);
+
+        /* seqlock write: odd, fence, payload, even */
+        const uint64_t seq = s.seq.load(std::memory_order_relaxed);
+        s.seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        s.frame = n;
+        s.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        s.rows = frame.rows;
+        s.cols = frame.cols;
+        s.type = frame.type();
+        if (frame.isContinuous()) std::memcpy(px, frame.data, row * frame.rows);
+        else
+            for (int r = 0; r < frame.rows; ++r) std::memcpy(px + r * row, frame.ptr(r), row);
+        s.seq.store(seq + 2, std::memory_order_release);
+
+        h.frames.store(n, std::memory_order_release);
+        return true;
+    }
+
+    uint64_t ShmPublisher::frames() const
+    {
+        return static_cast<const RingHeader*>(base_)->frames.load(std::memory_order_relaxed);
+    }
+
+    /* --------------------------------------------------------------------------
+     *  ShmReader
+     * ------------------------------------------------------------------------*/
+    std::unique_ptr<ShmReader> ShmReader::open(const std::string& name)
+    {
+        const int fd = shm_open(shm_name(name).c_str(), O_RDWR, 0);
+        if (fd < 0) return nullptr;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(RingHeader))
+        {
+            close(fd);
+            return nullptr;
+        }
+        const size_t size = static_cast<size_t>(st.st_size);
+        void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);   /* atomics need a writable mapping */
+        close(fd);
+        if (base == MAP_FAILED) return nullptr;
+
+        const RingHeader& h = *static_cast<const RingHeader*>(base);
+        const bool ring = std::memcmp(h.magic, kMagic, sizeof(kMagic)) == 0;
+        std::atomic_thread_fence(std::memory_order_acquire);   /* pairs with the fence before the magic is written */
+        if (!ring || h.version != kLayoutVersion || h.slots < 2 ||
+            sizeof(RingHeader) + h.slots * slot_stride(h.slot_bytes) > size)
+        {
+            munmap(base, size);
+            return nullptr;
+        }
+
+        std::unique_ptr<ShmReader> r(new ShmReader);
+        r->base_ = base;
+        r->size_ = size;
+        return r;
+    }
+
+    ShmReader::~ShmReader()
+    {
+        munmap(base_, size_);
+    }
+
+    uint64_t ShmReader::read_latest(cv::Mat& out, uint64_t after)
+    {
+        RingHeader& h = *static_cast<RingHeader*>(base_);
+        for (int attempt = 0; attempt < kReadAttempts; ++attempt)
+        {
+            const uint64_t n = h.frames.load(std::memory_order_acquire);
+            if (n == 0 || n <= after) return 0;
+
+            SlotHeader& s = *slot_at(base_, h, (n - 1) % h.slots);
+            const uint64_t seq0 = s.seq.load(std::memory_order_acquire);
+            if (seq0 & 1) continue;   /* the publisher lapped the ring onto this slot */
+
+            const uint64_t frame = s.frame;
+            const int rows = s.rows, cols = s.cols, type = s.type;
+            if (rows <= 0 || cols <= 0) continue;
+            out.create(rows, cols, type);
+            const size_t bytes = out.total() * out.elemSize();
+            if (bytes > h.slot_bytes) continue;
+            std::memcpy(out.data, reinterpret_cast<const char*>(&s) + sizeof(SlotHeader), bytes);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s.seq.load(std::memory_order_relaxed) == seq0 && frame > after) return frame;
+        }
+        return 0;
+    }
+
+#else
+
+    std::unique_ptr<ShmPublisher> ShmPublisher::create(const std::string&, size_t, int) { return nullptr; }
+    ShmPublisher::~ShmPublisher() = default;
+    bool ShmPublisher::publish(const cv::Mat&) { return false; }
+    uint64_t ShmPublisher::frames() const { return 0; }
+
+    std::unique_ptr<ShmReader> ShmReader::open(const std::string&) { return nullptr; }
+    ShmReader::~ShmReader() = default;
+    uint64_t ShmReader::read_latest(cv::Mat&, uint64_t) { return 0; }
+
+#endif
+
+    /* --------------------------------------------------------------------------
+     *  Figure publishing
+     * ------------------------------------------------------------------------*/
+    bool Figure::publish_shm(const std::string& name, int slots)
+    {
+        /* room for a BGR16 frame, the widest canvas_format() */
+        const size_t widest_pixel = 3 * sizeof(uint16_t);
+        shm_.reset();
+        shm_ = ShmPublisher::create(name, canvas_.total() * std::max(widest_pixel, canvas_.elemSize()), slots);
+        shm_name_ = name;
+        shm_slots_ = slots;
+        shm_sent_seq_ = frame_seq_ - 1;   /* the current canvas goes out with the next render() */
+        return shm_ != nullptr;
+    }
+
+    void Figure::stop_shm()
+    {
+        shm_.reset();
+    }
+
+    void Figure::publish_shm_frame()
+    {
+        if (!shm_ || shm_sent_seq_ == frame_seq_) return;
+        MPOCV_TRACE_SCOPE("shm_publish");
+        if (!shm_->publish(canvas_))
+        {
+            /* the frame outgrew its slots: replace the ring (stop if that fails) */
+            if (!publish_shm(shm_name_, shm_slots_) || !shm_->publish(canvas_))
+            {
+                shm_.reset();
+                return;
+            }
+        }
+        shm_sent_seq_ = frame_seq_;
+    }
+
+} // namespace mpocv
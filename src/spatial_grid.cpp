@@ -0,0 +1,46 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#include "spatial_grid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mpocv
+{
+    namespace
+    {
+        constexpr int kMaxCellsPerAxis = 2048;
+    } // namespace
+
+    void SpatialGrid::reset(double xmin, double xmax, double ymin, double ymax, size_t expected)
+    {
+        /* square-ish cell counts for about kPointsPerCell points each */
+        const double cells = std::max(1.0, static_cast<double>(expected) / kPointsPerCell);
+        const int side = static_cast<int>(std::min<double>(kMaxCellsPerAxis, std::max(1.0, std::ceil(std::sqrt(cells)))));
+        nx_ = ny_ = side;
+
+        if (!(xmax > xmin)) { xmin -= 0.5; xmax = xmin + 1.0; }
+        if (!(ymax > ymin)) { ymin -= 0.5; ymax = ymin + 1.0; }
+        x0_ = xmin; y0_ = ymin;
+        inv_w_ = nx_ / (xmax - xmin);
+        inv_h_ = ny_ / (ymax - ymin);
+
+        cells_.clear();
+        cells_.resize(static_cast<size_t>(nx_) * ny_);
+        size_ = 0;
+    }
+
+    size_t SpatialGrid::memory_bytes() const
+    {
+        size_t bytes = cells_.capacity() * sizeof(cells_[0]);
+        for (const auto& c : cells_) bytes += c.capacity() * sizeof(uint64_t);
+        return bytes;
+    }
+
+} // namespace mpocv
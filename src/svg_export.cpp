@@ -0,0 +1,600 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+// Streaming SVG output.
+//
+// The figure is written element by element through a fixed-size buffer; no
+// document tree is built. Geometry uses the same pixel mapping as the raster
+// path, so an SVG overlays the PNG of the same figure. Long line series are
+// reduced with decimate_min_max() and scatter markers identical to the last
+// one written on the same pixel are skipped, which bounds both memory and
+// file size by the output resolution rather than by the number of points.
+// Image commands are embedded as PNG at the figure's resolution.
+
+#include "figure.h"
+#include "decimate.h"
+#include "trace.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace mpocv
+{
+    namespace
+    {
+        constexpr double kSvgFontPx = 30.0;        ///< font-size per unit of OpenCV font scale (Hershey simplex).
+        constexpr size_t kSvgPointsPerColumn = 4;  ///< Line series longer than this many points per column are decimated.
+        constexpr size_t kSvgBufferBytes = 1 << 16;
+    } // namespace
+
+    /* --------------------------------------------------------------------------
+     *  Buffered writer
+     * ------------------------------------------------------------------------*/
+    class SvgWriter
+    {
+    public:
+        explicit SvgWriter(const std::string& filename)
+            : f_(std::fopen(filename.c_str(), "wb")), buf_(new char[kSvgBufferBytes])
+        {}
+
+        ~SvgWriter() { close(); }
+
+        bool ok() const { return f_ != nullptr && !failed_; }
+
+        bool close()
+        {
+            if (!f_) return false;
+            flush();
+            if (std::fclose(f_) != 0) failed_ = true;
+            f_ = nullptr;
+            return !failed_;
+        }
+
+        SvgWriter& raw(const char* s, size_t n)
+        {
+            if (len_ + n > kSvgBufferBytes) flush();
+            if (n > kSvgBufferBytes)
+            {
+                if (f_ && std::fwrite(s, 1, n, f_) != n) failed_ = true;
+                return *this;
+            }
+            std::memcpy(buf_.get() + len_, s, n);
+            len_ += n;
+            return *this;
+        }
+
+        SvgWriter& operator<<(const char* s) { return raw(s, std::strlen(s)); }
+        SvgWriter& operator<<(const std::string& s) { return raw(s.data(), s.size()); }
+        SvgWriter& operator<<(char c) { return raw(&c, 1); }
+
+        SvgWriter& operator<<(int v)
+        {
+            char tmp[16];
+            return raw(tmp, static_cast<size_t>(std::snprintf(tmp, sizeof tmp, "%d", v)));
+        }
+
+        /// Coordinate with at most two decimals and no trailing zeros.
+        SvgWriter& num(double v)
+        {
+            char tmp[32];
+            int n = std::snprintf(tmp, sizeof tmp, "%.2f", v);
+            if (n <= 0 || n >= static_cast<int>(sizeof tmp)) return raw("0", 1);
+            while (n > 1 && tmp[n - 1] == '0') --n;
+            if (tmp[n - 1] == '.') --n;
+            if (n == 2 && tmp[0] == '-' && tmp[1] == '0') return raw("0", 1);
+            return raw(tmp, static_cast<size_t>(n));
+        }
+
+        SvgWriter& color(const Color& c)
+        {
+            char tmp[8];
+            std::snprintf(tmp, sizeof tmp, "#%02x%02x%02x", c.r, c.g, c.b);
+            return raw(tmp, 7);
+        }
+
+        /// XML-escaped character data.
+        template<typename S>
+        SvgWriter& text(const S& s)
+        {
+            for (const char ch : s)
+            {
+                switch (ch)
+                {
+                case '&': *this << "&amp;"; break;
+                case '<': *this << "&lt;"; break;
+                case '>': *this << "&gt;"; break;
+                case '"': *this << "&quot;"; break;
+                default:  raw(&ch, 1); break;
+                }
+            }
+            return *this;
+        }
+
+        /// Base64 encoding of @p n bytes (for embedded data: URIs).
+        SvgWriter& base64(const unsigned char* p, size_t n)
+        {
+            static const char digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            char quad[4];
+            for (size_t i = 0; i < n; i += 3)
+            {
+                const unsigned v = (p[i] << 16) | (i + 1 < n ? p[i + 1] << 8 : 0) | (i + 2 < n ? p[i + 2] : 0);
+                quad[0] = digits[(v >> 18) & 63];
+                quad[1] = digits[(v >> 12) & 63];
+                quad[2] = i + 1 < n ? digits[(v >> 6) & 63] : '=';
+                quad[3] = i + 2 < n ? digits[v & 63] : '=';
+                raw(quad, 4);
+            }
+            return *this;
+        }
+
+        /// fill / stroke attributes of a shape.
+        SvgWriter& style(const ShapeStyle& s)
+        {
+            if (s.fill_alpha > 0.0f)
+            {
+                *this << " fill=\""; color(s.fill_color) << '"';
+                if (s.fill_alpha < 1.0f) { *this << " fill-opacity=\""; num(s.fill_alpha) << '"'; }
+            }
+            else
+            {
+                *this << " fill=\"none\"";
+            }
+            if (s.thickness > 0.0f)
+            {
+                *this << " stroke=\""; color(s.line_color) << "\" stroke-width=\"" << static_cast<int>(s.thickness) << '"';
+            }
+            return *this;
+        }
+
+        /// Text element at a baseline-left position, like cv::putText.
+        template<typename S>
+        SvgWriter& label(const S& s, int x, int y, double font_scale, const Color& c = Color::Black(), int thickness = 1)
+        {
+            *this << "<text x=\"" << x << "\" y=\"" << y << "\" font-size=\"";
+            num(font_scale * kSvgFontPx) << "\" fill=\"";
+            color(c) << '"';
+            if (thickness > 1) *this << " font-weight=\"bold\"";
+            *this << '>';
+            return text(s) << "</text>\n";
+        }
+
+    private:
+        void flush()
+        {
+            if (f_ && len_ > 0 && std::fwrite(buf_.get(), 1, len_, f_) != len_) failed_ = true;
+            len_ = 0;
+        }
+
+        std::FILE*              f_;
+        std::unique_ptr<char[]> buf_;
+        size_t                  len_{ 0 };
+        bool                    failed_{ false };
+    };
+
+    namespace
+    {
+        /**
+         * Poly-line path data with off-canvas culling: segments entirely on
+         * one side of the canvas are dropped and the pen is lifted, so only
+         * visible geometry is written.
+         */
+        struct PathSink
+        {
+            SvgWriter& out;
+            double     x0, y0, x1, y1;   ///< Culling rectangle.
+            PixelPoint prev{};
+            int        prev_code{ 0 };
+            bool       have_prev{ false };
+            bool       pen_down{ false };
+
+            int code(const PixelPoint& p) const
+            {
+                return (p.x < x0 ? 1 : p.x > x1 ? 2 : 0) | (p.y < y0 ? 4 : p.y > y1 ? 8 : 0);
+            }
+
+            void operator()(const PixelPoint& p)
+            {
+                const int c = code(p);
+                if (have_prev && (c & prev_code) == 0)
+                {
+                    if (!pen_down)
+                    {
+                        out << 'M'; out.num(prev.x) << ' '; out.num(prev.y) << 'L';
+                        pen_down = true;
+                    }
+                    else
+                    {
+                        out << ' ';
+                    }
+                    out.num(p.x) << ' '; out.num(p.y);
+                }
+                else
+                {
+                    pen_down = false;
+                }
+                prev = p; prev_code = c; have_prev = true;
+            }
+        };
+    } // namespace
+
+    /* --------------------------------------------------------------------------
+     *  Figure SVG output
+     * ------------------------------------------------------------------------*/
+    void Figure::save_svg(const std::string& filename)
+    {
+        MPOCV_TRACE_SCOPE("save_svg");
+        SvgWriter out(filename);
+        if (!out.ok()) return;
+
+        out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << width_ << "\" height=\"" << height_
+            << "\" viewBox=\"0 0 " << width_ << ' ' << height_ << "\" font-family=\"sans-serif\">\n";
+        write_svg(out, 0, 0);
+        out << "</svg>\n";
+        out.close();
+    }
+
+    void Figure::write_svg(SvgWriter& out, int ox, int oy)
+    {
+        if (ox != 0 || oy != 0) out << "<g transform=\"translate(" << ox << ' ' << oy << ")\">\n";
+        out << "<rect width=\"" << width_ << "\" height=\"" << height_ << "\" fill=\"#ffffff\"/>\n";
+
+        if (!subplots_.empty())
+        {
+            if (!title_.empty()) out.label(title_, kMargin, kMargin / 2, 0.6);
+            for (int i = 0; i < static_cast<int>(subplots_.size()); ++i)
+            {
+                const cv::Rect r = subplot_rect(i);
+                subplots_[i].write_svg(out, r.x, r.y);
+            }
+            if (ox != 0 || oy != 0) out << "</g>\n";
+            return;
+        }
+
+        /* limits as the next render() will compute them; the raster state is left alone */
+        const Axes saved = axes_;
+        const bool fresh = dirty_;
+        if (fresh) update_limits();
+
+        const TickInfo xt = make_ticks(axes_.xmin, axes_.xmax);
+        const TickInfo yt = make_ticks(axes_.ymin, axes_.ymax);
+        const double sx = plot_width() / (axes_.xmax - axes_.xmin);
+        const double sy = plot_height() / (axes_.ymax - axes_.ymin);
+        auto to_px = [&](double x, double y)
+            {
+                return PixelPoint{ kMarginLeft + (x - axes_.xmin) * sx, height_ - kMarginBottom - (y - axes_.ymin) * sy };
+            };
+        auto line = [&](cv::Point a, cv::Point b)
+            {
+                out << "<line x1=\"" << a.x << "\" y1=\"" << a.y << "\" x2=\"" << b.x << "\" y2=\"" << b.y << "\"/>\n";
+            };
+
+        /* grid --------------------------------------------------------------- */
+        if (axes_.grid)
+        {
+            out << "<g stroke=\"#dcdcdc\" stroke-width=\"1\">\n";
+            for (double xv : xt.locs)
+                if (xv >= axes_.xmin && xv <= axes_.xmax) line(data_to_pixel(xv, axes_.ymin), data_to_pixel(xv, axes_.ymax));
+            for (double yv : yt.locs)
+                if (yv >= axes_.ymin && yv <= axes_.ymax) line(data_to_pixel(axes_.xmin, yv), data_to_pixel(axes_.xmax, yv));
+            out << "</g>\n";
+        }
+
+        /* axes --------------------------------------------------------------- */
+        out << "<g stroke=\"#000000\" stroke-width=\"1\">\n";
+        line({ kMarginLeft, height_ - kMarginBottom }, { width_ - kMarginRight, height_ - kMarginBottom });
+        line({ kMarginLeft, kMarginTop }, { kMarginLeft, height_ - kMarginBottom });
+        for (double xv : xt.locs)
+        {
+            const cv::Point p = data_to_pixel(xv, axes_.ymin);
+            line(p, { p.x, p.y + kTickLen });
+        }
+        for (double yv : yt.locs)
+        {
+            const cv::Point p = data_to_pixel(axes_.xmin, yv);
+            line({ p.x - kTickLen, p.y }, p);
+        }
+        out << "</g>\n";
+        for (size_t i = 0; i < xt.locs.size(); ++i)
+        {
+            const cv::Point p = data_to_pixel(xt.locs[i], axes_.ymin);
+            out.label(xt.labels[i], p.x - 10, p.y + 18, 0.4);
+        }
+        for (size_t i = 0; i < yt.locs.size(); ++i)
+        {
+            const cv::Point p = data_to_pixel(axes_.xmin, yt.locs[i]);
+            out.label(yt.labels[i], p.x - 30, p.y + 4, 0.4);
+        }
+
+        /* commands ----------------------------------------------------------- */
+        for (const auto& cmd : cmds_)
+        {
+            switch (cmd.type)
+            {
+            case CmdType::Line:
+            {
+                const auto& X = cmd.line().x;
+                const auto& Y = cmd.line().y;
+                const size_t n = std::min(X.size(), Y.size());
+                if (n < 2) break;
+                const double pad = std::max(1.0f, cmd.line().thickness) + 1.0;
+                out << "<path fill=\"none\" stroke=\""; out.color(cmd.color)
+                    << "\" stroke-width=\"" << std::max(1, static_cast<int>(cmd.line().thickness))
+                    << "\" stroke-linejoin=\"round\" stroke-linecap=\"round\" d=\"";
+                PathSink sink{ out, -pad, -pad, width_ + pad, height_ + pad };
+                if (n > kSvgPointsPerColumn * static_cast<size_t>(std::max(1, plot_width())))
+                    decimate_min_max(X, Y, to_px, sink);
+                else
+                    for (size_t i = 0; i < n; ++i) sink(to_px(X[i], Y[i]));
+                out << "\"/>\n";
+                break;
+            }
+            case CmdType::Scatter:
+            {
+                const ScatterData& sd = cmd.scatter();
+                const size_t n = std::min(sd.x.size(), sd.y.size());
+                if (n == 0) break;
+                const bool per_color = sd.color_index.size() >= n;
+                const bool per_size = sd.sizes.size() >= n;
+                const bool uniform = !per_color && !per_size;
+                const Color* lut = colormap_lut(sd.cmap);
+
+                /* last marker key written per canvas pixel: an identical marker on the same pixel adds nothing */
+                std::vector<uint32_t> seen(static_cast<size_t>(width_) * height_, 0);
+                if (uniform) { out << "<path fill=\""; out.color(cmd.color) << "\" d=\""; }
+                for (size_t i = 0; i < n; ++i)
+                {
+                    const PixelPoint p = to_px(sd.x[i], sd.y[i]);
+                    const double r = std::max(0.5, per_size ? sd.sizes[i] : static_cast<double>(sd.marker_size));
+                    if (!(p.x >= -r && p.x <= width_ + r && p.y >= -r && p.y <= height_ + r)) continue;
+                    const int ci = per_color ? static_cast<int>(sd.color_index[i]) & 255 : 0;
+                    const long px = std::lround(p.x), py = std::lround(p.y);
+                    if (px >= 0 && px < width_ && py >= 0 && py < height_)
+                    {
+                        const uint32_t key = (static_cast<uint32_t>(ci) << 16 | static_cast<uint32_t>(std::min(r, 65534.0))) + 1;
+                        uint32_t& slot = seen[static_cast<size_t>(py) * width_ + static_cast<size_t>(px)];
+                        if (slot == key) continue;
+                        slot = key;
+                    }
+                    if (uniform)
+                    {
+                        out << 'M'; out.num(p.x - r) << ' '; out.num(p.y);
+                        out << 'a'; out.num(r) << ' '; out.num(r) << " 0 1 0 "; out.num(2 * r) << " 0";
+                        out << 'a'; out.num(r) << ' '; out.num(r) << " 0 1 0 "; out.num(-2 * r) << " 0";
+                    }
+                    else
+                    {
+                        out << "<circle cx=\""; out.num(p.x) << "\" cy=\""; out.num(p.y) << "\" r=\""; out.num(r) << "\" fill=\"";
+                        out.color(per_color ? lut[ci] : cmd.color) << "\"/>\n";
+                    }
+                }
+                if (uniform) out << "\"/>\n";
+                break;
+            }
+            case CmdType::Text:
+            {
+                const std::string& text = scratch_text(cmd.txt().text);
+                const cv::Point p = anchored_text_pos(cmd.txt(), text);
+                out.label(text, p.x, p.y, cmd.txt().font_scale, cmd.color, cmd.txt().thickness);
+                break;
+            }
+            case CmdType::Circle:
+            {
+                const auto& d = cmd.circle();
+                const cv::Point c = data_to_pixel(d.cx, d.cy);
+                const int radius_px = static_cast<int>(d.radius * sx);
+                out << "<circle cx=\"" << c.x << "\" cy=\"" << c.y << "\" r=\"" << radius_px << '"';
+                out.style(d.style) << "/>\n";
+                break;
+            }
+            case CmdType::RectXYWH:
+            case CmdType::RectLTRB:
+            {
+                const auto& d = cmd.rect();
+                const cv::Rect r(data_to_pixel(d.x0, d.y0), data_to_pixel(d.x1, d.y1));
+                out << "<rect x=\"" << r.x << "\" y=\"" << r.y << "\" width=\"" << r.width << "\" height=\"" << r.height << '"';
+                out.style(d.style) << "/>\n";
+                break;
+            }
+            case CmdType::RotatedRect:
+            {
+                const auto& d = cmd.rot_rect();
+                cv::RotatedRect r(data_to_pixel(d.cx, d.cy),
+                    cv::Size2f(static_cast<float>(d.width * sx), static_cast<float>(d.height * sy)),
+                    static_cast<float>(-d.angle_deg));
+                cv::Point2f verts[4]; r.points(verts);
+                out << "<polygon points=\"";
+                for (int i = 0; i < 4; ++i) { if (i) out << ' '; out.num(verts[i].x) << ','; out.num(verts[i].y); }
+                out << '"';
+                out.style(d.style) << "/>\n";
+                break;
+            }
+            case CmdType::Polygon:
+            {
+                const auto& d = cmd.polygon();
+                out << "<polygon points=\"";
+                for (size_t i = 0; i < d.x.size(); ++i)
+                {
+                    const PixelPoint p = to_px(d.x[i], d.y[i]);
+                    if (i) out << ' ';
+                    out.num(p.x) << ','; out.num(p.y);
+                }
+                out << '"';
+                out.style(d.style) << "/>\n";
+                break;
+            }
+            case CmdType::Ellipse:
+            {
+                const auto& d = cmd.ellipse();
+                const cv::Point c = data_to_pixel(d.cx, d.cy);
+                out << "<ellipse cx=\"" << c.x << "\" cy=\"" << c.y << "\" rx=\"";
+                out.num(0.5 * d.width * sx) << "\" ry=\""; out.num(0.5 * d.height * sy) << "\" transform=\"rotate(";
+                out.num(-d.angle_deg) << ' ' << c.x << ' ' << c.y << ")\"";
+                out.style(d.style) << "/>\n";
+                break;
+            }
+            case CmdType::Segments:
+            {
+                /* one path per color; segments entirely off one side of the canvas are dropped */
+                const auto& d = cmd.segments();
+                const size_t n = std::min(d.x.size(), d.y.size()) / 2;
+                const bool per_color = d.color_index.size() >= n;
+                bool used[256] = {};
+                if (per_color) { for (size_t k = 0; k < n; ++k) used[static_cast<int>(d.color_index[k]) & 255] = true; }
+                else used[0] = true;
+                const Color* lut = colormap_lut(d.cmap);
+                PathSink cull{ out, -1.0, -1.0, width_ + 1.0, height_ + 1.0 };
+                for (int ci = 0; ci < 256; ++ci)
+                {
+                    if (!used[ci]) continue;
+                    out << "<path fill=\"none\" stroke=\"";
+                    out.color(per_color ? lut[ci] : cmd.color) << "\" stroke-width=\"" << std::max(1, static_cast<int>(d.thickness)) << "\" d=\"";
+                    for (size_t k = 0; k < n; ++k)
+                    {
+                        if (per_color && (static_cast<int>(d.color_index[k]) & 255) != ci) continue;
+                        const PixelPoint a = to_px(d.ox + d.sx * d.x[2 * k], d.oy + d.sy * d.y[2 * k]);
+                        const PixelPoint b = to_px(d.ox + d.sx * d.x[2 * k + 1], d.oy + d.sy * d.y[2 * k + 1]);
+                        if (cull.code(a) & cull.code(b)) continue;
+                        out << 'M'; out.num(a.x) << ' '; out.num(a.y) << 'L'; out.num(b.x) << ' '; out.num(b.y);
+                    }
+                    out << "\"/>\n";
+                }
+                break;
+            }
+            case CmdType::Histogram:
+            {
+                /* all bars in one path, like the raster fill */
+                const auto& d = cmd.hist();
+                double lo, hi;
+                const std::vector<uint64_t>* counts = hist_bins(d, lo, hi);
+                if (!counts) break;
+                const double w = (hi - lo) / counts->size();
+                const double span = axes_.ymax - axes_.ymin;
+                auto clamp_y = [&](double y) { return std::min(std::max(y, axes_.ymin - span), axes_.ymax + span); };
+                const double base = to_px(lo, clamp_y(0.0)).y;
+                out << "<path d=\"";
+                for (size_t i = 0; i < counts->size(); ++i)
+                {
+                    if ((*counts)[i] == 0) continue;
+                    const PixelPoint a = to_px(lo + w * i, clamp_y(static_cast<double>((*counts)[i])));
+                    const PixelPoint b = to_px(lo + w * (i + 1), 0.0);
+                    out << 'M'; out.num(a.x) << ' '; out.num(base) << 'V'; out.num(a.y) << 'H'; out.num(b.x) << 'V'; out.num(base) << 'Z';
+                }
+                out << '"';
+                out.style(d.style) << "/>\n";
+                break;
+            }
+            case CmdType::LineMatrix:
+            {
+                /* one path per channel, reduced per pixel column like a single line */
+                const auto& d = cmd.matrix();
+                const size_t n = d.x.size();
+                if (n < 2 || d.y.size() < n * static_cast<size_t>(d.channels)) break;
+                const double pad = std::max(1.0f, d.thickness) + 1.0;
+                const bool reduce = n > kSvgPointsPerColumn * static_cast<size_t>(std::max(1, plot_width()));
+                for (int k = 0; k < d.channels; ++k)
+                {
+                    const Series y = d.channel(k);
+                    out << "<path fill=\"none\" stroke=\""; out.color(d.channel_color(k))
+                        << "\" stroke-width=\"" << std::max(1, static_cast<int>(d.thickness))
+                        << "\" stroke-linejoin=\"round\" stroke-linecap=\"round\" d=\"";
+                    PathSink sink{ out, -pad, -pad, width_ + pad, height_ + pad };
+                    if (reduce)
+                        decimate_min_max(d.x, y, to_px, sink);
+                    else
+                        for (size_t i = 0; i < n; ++i) sink(to_px(d.x[i], y[i]));
+                    out << "\"/>\n";
+                }
+                break;
+            }
+            case CmdType::FillBetween:
+            {
+                /* the same decimated outline as the raster fill, as one closed path */
+                const auto& d = cmd.band();
+                std::vector<PixelPoint> outline;
+                band_outline(d.x, d.y_lo, d.y_hi, to_px, outline);
+                if (outline.size() < 3) break;
+                out << "<path d=\"M";
+                for (size_t i = 0; i < outline.size(); ++i)
+                {
+                    if (i == 1) out << 'L';
+                    else if (i > 1) out << ' ';
+                    out.num(outline[i].x) << ' '; out.num(outline[i].y);
+                }
+                out << "Z\"";
+                out.style(d.style) << "/>\n";
+                break;
+            }
+            case CmdType::Image:
+            {
+                /* raster content: embed the visible part at the figure's resolution */
+                cv::Rect dst;
+                cv::Mat bgr;
+                std::vector<unsigned char> png;
+                if (!colorize_image(cmd.image(), cmd.image().interp, dst, bgr) || !cv::imencode(".png", bgr, png)) break;
+                out << "<image x=\"" << dst.x << "\" y=\"" << dst.y << "\" width=\"" << dst.width << "\" height=\"" << dst.height
+                    << "\" preserveAspectRatio=\"none\" href=\"data:image/png;base64,";
+                out.base64(png.data(), png.size()) << "\"/>\n";
+                break;
+            }
+            }
+        }
+
+        /* legend ------------------------------------------------------------- */
+        LegendLayout lay;
+        if (legend_layout(lay))
+        {
+            const cv::Point a = lay.anchor;
+            out << "<rect x=\"" << a.x << "\" y=\"" << a.y << "\" width=\"" << lay.box_w << "\" height=\"" << lay.box_h
+                << "\" fill=\"#ffffff\" stroke=\"#000000\" stroke-width=\"1\"/>\n";
+            for (size_t i = 0; i < lay.items.size(); ++i)
+            {
+                const int y = a.y + 5 + static_cast<int>(i) * lay.line_h + lay.line_h / 2;
+                const PlotCommand* pc = lay.items[i];
+                switch (pc->type)
+                {
+                case CmdType::Line:
+                case CmdType::Segments:
+                case CmdType::LineMatrix:
+                    out << "<line x1=\"" << a.x + 5 << "\" y1=\"" << y << "\" x2=\"" << a.x + 5 + lay.swatch << "\" y2=\"" << y
+                        << "\" stroke-width=\"2\" stroke=\"";
+                    out.color(pc->color) << "\"/>\n";
+                    break;
+                case CmdType::Scatter:
+                case CmdType::Circle:
+                    out << "<circle cx=\"" << a.x + 5 + lay.swatch / 2 << "\" cy=\"" << y << "\" r=\"4\" fill=\"";
+                    out.color(pc->color) << "\"/>\n";
+                    break;
+                default:
+                    out << "<rect x=\"" << a.x + 5 << "\" y=\"" << y - 4 << "\" width=\"" << lay.swatch << "\" height=\"8\" fill=\"";
+                    out.color(pc->color) << "\"/>\n";
+                }
+                out.label(pc->label, a.x + 5 + lay.swatch + 8, y + 4, 0.4);
+            }
+        }
+
+        /* title & labels ----------------------------------------------------- */
+        if (!title_.empty())  out.label(title_, kMargin, kMargin / 2, 0.6);
+        if (!xlabel_.empty()) out.label(xlabel_, width_ / 2 - 40, height_ - 10, 0.5);
+        if (!ylabel_.empty())
+        {
+            int bl = 0;
+            const cv::Size sz = cv::getTextSize(ylabel_, cv::FONT_HERSHEY_SIMPLEX, 0.5, 1, &bl);
+            const int x = kMarginLeft - 55 + sz.height;
+            const int y = kMarginTop + plot_height() / 2;
+            out << "<text transform=\"translate(" << x << ' ' << y << ") rotate(-90)\" text-anchor=\"middle\" font-size=\"";
+            out.num(0.5 * kSvgFontPx) << "\" fill=\"#000000\">";
+            out.text(ylabel_) << "</text>\n";
+        }
+
+        if (fresh) axes_ = saved;
+        if (ox != 0 || oy != 0) out << "</g>\n";
+    }
+
+} // namespace mpocv
@@ -0,0 +1,165 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#include "trace.h"
+
+#ifdef MPOCV_ENABLE_TRACING
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mpocv
+{
+    namespace
+    {
+        struct Event
+        {
+            const char* name;
+            int64_t     ts_ns;
+            int64_t     dur_ns;
+        };
+
+        /// Single-writer event buffer owned by one thread.
+        struct ThreadBuffer
+        {
+            static constexpr size_t kCapacity = size_t(1) << 16;
+
+            uint32_t                 tid{ 0 };
+            std::unique_ptr<Event[]> events{ new Event[kCapacity] };
+            std::atomic<size_t>      count{ 0 };    ///< Published events (release by writer).
+            std::atomic<uint64_t>    dropped{ 0 };
+        };
+
+        struct Registry
+        {
+            std::mutex                                 mtx;
+            std::vector<std::shared_ptr<ThreadBuffer>> buffers;  ///< Kept alive after thread exit.
+        };
+
+        Registry& registry()
+        {
+            static Registry r;
+            return r;
+        }
+
+        std::atomic<bool> g_enabled{ true };
+
+        const std::chrono::steady_clock::time_point g_epoch = std::chrono::steady_clock::now();
+
+        int64_t now_ns()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - g_epoch).count();
+        }
+
+        ThreadBuffer& thread_buffer()
+        {
+            thread_local std::shared_ptr<ThreadBuffer> buf = []
+                {
+                    auto b = std::make_shared<ThreadBuffer>();
+                    Registry& r = registry();
+                    std::lock_guard<std::mutex> lock(r.mtx);
+                    b->tid = static_cast<uint32_t>(r.buffers.size() + 1);
+                    r.buffers.push_back(b);
+                    return b;
+                }();
+            return *buf;
+        }
+
+        void write_escaped(std::ostream& os, const char* s)
+        {
+            for (; *s; ++s)
+            {
+                if (*s == '"' || *s == '\\') os << '\\';
+                os << *s;
+            }
+        }
+    } // namespace
+
+    void Tracer::enable(bool on) { g_enabled.store(on, std::memory_order_relaxed); }
+    bool Tracer::enabled() { return g_enabled.load(std::memory_order_relaxed); }
+
+    bool Tracer::write_json(const std::string& filename)
+    {
+        std::ofstream os(filename);
+        if (!os) return false;
+
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mtx);
+
+        os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+        bool first = true;
+        for (const auto& b : r.buffers)
+        {
+            os << (first ? "" : ",\n")
+               << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << b->tid
+               << ",\"args\":{\"name\":\"mpocv thread " << b->tid << "\"}}";
+            first = false;
+
+            const size_t n = b->count.load(std::memory_order_acquire);
+            for (size_t i = 0; i < n; ++i)
+            {
+                const Event& e = b->events[i];
+                os << ",\n{\"name\":\"";
+                write_escaped(os, e.name);
+                os << "\",\"cat\":\"mpocv\",\"ph\":\"X\",\"pid\":1,\"tid\":" << b->tid
+                   << ",\"ts\":" << e.ts_ns / 1000 << '.' << (e.ts_ns % 1000) / 100
+                   << ",\"dur\":" << e.dur_ns / 1000 << '.' << (e.dur_ns % 1000) / 100 << '}';
+            }
+        }
+        os << "\n]}\n";
+        return static_cast<bool>(os);
+    }
+
+    void Tracer::clear()
+    {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mtx);
+        for (const auto& b : r.buffers)
+        {
+            b->count.store(0, std::memory_order_release);
+            b->dropped.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t Tracer::dropped()
+    {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mtx);
+        uint64_t total = 0;
+        for (const auto& b : r.buffers) total += b->dropped.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    TraceScope::TraceScope(const char* name)
+        : name_(g_enabled.load(std::memory_order_relaxed) ? name : nullptr),
+        t0_ns_(name_ ? now_ns() : 0)
+    {}
+
+    TraceScope::~TraceScope()
+    {
+        if (!name_) return;
+        const int64_t t1 = now_ns();
+        ThreadBuffer& b = thread_buffer();
+        const size_t i = b.count.load(std::memory_order_relaxed);
+        if (i >= ThreadBuffer::kCapacity)
+        {
+            b.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        b.events[i] = { name_, t0_ns_, t1 - t0_ns_ };
+        b.count.store(i + 1, std::memory_order_release);
+    }
+
+} // namespace mpocv
+
+#endif // MPOCV_ENABLE_TRACING
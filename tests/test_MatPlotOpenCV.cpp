@@ -17,7 +17,7 @@ int main()
 
     // ------------------------ Two Sine Waves ------------------------
 
-    std::vector<double> xs, ys1, ys2;
+    std::vector<double> xs, ys1, ys2, band_lo, band_hi;
     const int N = 200;
     for (int i = 0; i < N; ++i)
     {
@@ -25,9 +25,12 @@ int main()
         xs.push_back(t);
         ys1.push_back(std::sin(t));
         ys2.push_back(0.5 * std::sin(t + 0.5));
+        band_lo.push_back(ys1.back() - 0.15);
+        band_hi.push_back(ys1.back() + 0.15);
     }
 
     Figure fig1(800, 600);
+    fig1.fill_between(xs, band_lo, band_hi, ShapeStyle{ Color::Blue(), 0.0f, Color::Blue(), 0.2f }, "sin(t) +/- 0.15");
     fig1.plot(xs, ys1, Color::Blue(), 2.0f, "sin(t)");
     fig1.plot(xs, ys2, Color::Cyan(), 2.0f, "0.5*sin(t+0.5)");
     fig1.scatter({ M_PI / 2 }, { 1.0 }, Color::Red(), 6.0f);
@@ -38,8 +41,13 @@ int main()
     fig1.title("Two sine waves");
     fig1.xlabel("x-axis");
     fig1.ylabel("y-axis");
+    /* hit-test the canvas centre and mark the nearest sample */
+    const PickResult hit = fig1.pick(400, 300, 20.0);
+    if (hit.found) fig1.scatter({ hit.x }, { hit.y }, Color::Magenta(), 5.0f);
     fig1.show("Demo Figure 1");
     fig1.save("demo1_sine_circle.png");
+    fig1.canvas_format(CanvasFormat::BGRA8);   /* transparent background for compositing */
+    fig1.save("demo1_sine_circle_alpha.png");
 
     // ------------------------ 2D Object Path ------------------------
 
@@ -59,6 +67,7 @@ int main()
     fig2.ylabel("Y Position");
     fig2.show("Demo Figure 2");
     fig2.save("demo2_path.png");
+    fig2.save("demo2_path.svg");
 
     // ------------------------ Shape Drawing Test ------------------------
 
@@ -120,7 +129,86 @@ int main()
     fig3.show("Demo Figure 3");
     fig3.save("demo3_shapes.png");
 
+    // ------------------------ Subplot Grid ------------------------
+
+    Figure fig4(1000, 700);
+    fig4.title("Subplot Grid");
+    for (int k = 1; k <= 4; ++k)
+    {
+        std::vector<double> yk;
+        for (double t : xs) yk.push_back(std::sin(k * t));
+
+        Figure& ax = fig4.subplot(2, 2, k);
+        ax.plot(xs, yk, Color::Blue(), 1.0f, "sin(" + std::to_string(k) + "t)");
+        ax.grid(true);
+        ax.legend(true, "southWest");
+        ax.xlabel("t");
+    }
+    fig4.show("Demo Figure 4");
+    fig4.save("demo4_subplots.png");
+
+    // ------------------------ Colored Scatter ------------------------
+
+    Figure fig5(700, 600);
+    std::vector<double> sx, sy, sv, ss;
+    for (int i = 0; i < 400; ++i)
+    {
+        const double a = 0.05 * i;
+        sx.push_back(a * std::cos(a));
+        sy.push_back(a * std::sin(a));
+        sv.push_back(a);
+        ss.push_back(2.0 + 0.3 * a);
+    }
+    fig5.scatter_colored(sx, sy, sv, ss, Colormap::Viridis, 0.0, 0.0, "spiral");
+    fig5.equal_scale(true);
+    fig5.grid(true);
+    fig5.title("Colored Scatter");
+    fig5.show("Demo Figure 5");
+    fig5.save("demo5_colored_scatter.png");
+
+    // ------------------------ Heat Map ------------------------
+
+    Figure fig6(700, 600);
+    cv::Mat field(120, 160, CV_32FC1);
+    for (int r = 0; r < field.rows; ++r)
+        for (int c = 0; c < field.cols; ++c)
+            field.at<float>(r, c) = static_cast<float>(std::sin(0.08 * c) * std::cos(0.11 * r));
+    fig6.image(field, -4.0, -3.0, 4.0, 3.0, Colormap::Jet, -1.0, 1.0, ImageInterp::Bilinear);
+    fig6.contour(field, { -0.5, 0.0, 0.5 }, -4.0, -3.0, 4.0, 3.0, Colormap::Gray, 1.0f);
+    fig6.axis_tight();
+    fig6.title("Heat Map");
+    fig6.show("Demo Figure 6");
+    fig6.save("demo6_heatmap.png");
+
+    // ------------------------
+    Figure fig7(700, 500);
+    std::vector<double> samples(200000);
+    for (size_t i = 0; i < samples.size(); ++i)   /* sum of three uniforms: roughly bell-shaped */
+        samples[i] = std::fmod(i * 0.6180339887, 1.0) + std::fmod(i * 0.7548776662, 1.0) + std::fmod(i * 0.5698402910, 1.0);
+    fig7.hist(std::move(samples), 40, ShapeStyle{ Color::Black(), 1.0f, Color::Cyan(), 0.8f }, "samples");
+    fig7.legend(true);
+    fig7.title("Histogram");
+    fig7.show("Demo Figure 7");
+    fig7.save("demo7_hist.png");
+
+    // ------------------------
+    Figure fig8(800, 500);
+    std::vector<double> t8(2000);
+    cv::Mat channels(16, static_cast<int>(t8.size()), CV_32FC1);
+    for (int i = 0; i < channels.cols; ++i)
+    {
+        t8[i] = i * 0.005;
+        for (int k = 0; k < channels.rows; ++k)
+            channels.at<float>(k, i) = static_cast<float>(k + 0.4 * std::sin(t8[i] * (1.0 + 0.5 * k)));
+    }
+    fig8.plot_matrix(t8, channels, Colormap::Tab10, 1.0f, "channels");
+    fig8.title("16 channels, shared time base");
+    fig8.show("Demo Figure 8");
+    fig8.save("demo8_matrix.png");
+
     // ------------------------
+    // Explore the channels: wheel zooms, left drag pans, 'r' resets, Esc returns
+    fig8.interact("Demo Figure 8");
     cv::waitKey(0);
     return 0;
 }
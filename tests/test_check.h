@@ -0,0 +1,44 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#pragma once
+#include <cstdio>
+
+/**
+ * @file test_check.h
+ * @brief Minimal check macro for the ctest executables (no test framework).
+ *
+ * MPOCV_CHECK reports a failed condition with its location and keeps going;
+ * a test's main() returns mpocv_test_result() so ctest sees the outcome.
+ */
+
+namespace mpocv_test
+{
+    inline int& failures()
+    {
+        static int n = 0;
+        return n;
+    }
+} // namespace mpocv_test
+
+#define MPOCV_CHECK(cond)                                                                   \
+    do                                                                                      \
+    {                                                                                       \
+        if (!(cond))                                                                        \
+        {                                                                                   \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);   \
+            ++mpocv_test::failures();                                                       \
+        }                                                                                   \
+    } while (0)
+
+/// Exit code for main(): 0 if every check passed.
+inline int mpocv_test_result()
+{
+    if (mpocv_test::failures() == 0) std::puts("all checks passed");
+    return mpocv_test::failures() == 0 ? 0 : 1;
+}
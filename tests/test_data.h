@@ -0,0 +1,38 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+#pragma once
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+/**
+ * @file test_data.h
+ * @brief Data files shared by the ctest executables.
+ */
+
+namespace mpocv_test
+{
+    /**
+     * @brief Write @p n frames of two interleaved float32 channels (i, f(i)) to @p path.
+     *
+     * Read back with load_raw(path, SampleType::Float32, 2, channel).
+     */
+    template<typename F>
+    void write_raw(const std::filesystem::path& path, int n, F f)
+    {
+        std::vector<float> frames(2 * static_cast<size_t>(n));
+        for (int i = 0; i < n; ++i)
+        {
+            frames[2 * i] = static_cast<float>(i);
+            frames[2 * i + 1] = static_cast<float>(f(i));
+        }
+        std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(frames.data()),
+            static_cast<std::streamsize>(frames.size() * sizeof(float)));
+    }
+} // namespace mpocv_test
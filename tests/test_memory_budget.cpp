@@ -0,0 +1,145 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+// memory_budget(): DecimateOldest thins owned series, while series viewing a
+// mapped file are dropped whole and never copied into the figure's memory
+// resource; pick() stays consistent while DropOldest trims the front.
+
+#include <cmath>
+#include <filesystem>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "figure.h"
+#include "series_io.h"
+#include "test_check.h"
+#include "test_data.h"
+
+using namespace mpocv;
+
+namespace
+{
+    namespace fs = std::filesystem;
+
+    constexpr int kN = 100000;   ///< Points per series.
+
+    /// Forwards to the default resource and counts the bytes requested.
+    class CountingResource : public std::pmr::memory_resource
+    {
+    public:
+        size_t bytes = 0;
+
+    private:
+        void* do_allocate(size_t n, size_t align) override
+        {
+            bytes += n;
+            return std::pmr::get_default_resource()->allocate(n, align);
+        }
+        void do_deallocate(void* p, size_t n, size_t align) override
+        {
+            std::pmr::get_default_resource()->deallocate(p, n, align);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& o) const noexcept override { return this == &o; }
+    };
+
+    /// Mapped series only: tightening the budget drops the oldest and allocates nothing.
+    void mapped_series_are_dropped_not_copied(const Series& t, const Series& v)
+    {
+        CountingResource counting;
+        Figure fig(480, 360, &counting);
+        fig.plot(t, v, Color::Blue(), 1.f, "old");
+        fig.plot(t, v, Color::Red(), 1.f, "new");
+        fig.render();
+
+        const size_t before = counting.bytes;
+        fig.memory_budget(fig.memory_usage().commands() - 1, MemoryPolicy::DecimateOldest);
+        MPOCV_CHECK(counting.bytes == before);
+
+        const MemoryUsage mu = fig.memory_usage();
+        MPOCV_CHECK(mu.series.size() == 1);
+        if (mu.series.size() != 1) return;
+        MPOCV_CHECK(mu.series[0].label == "new");
+        MPOCV_CHECK(mu.series[0].points == static_cast<size_t>(kN));
+        MPOCV_CHECK(mu.series[0].bytes < sizeof(PlotCommand) + 256);
+        fig.render();
+    }
+
+    /// Owned and mapped series side by side: only the owned one is thinned.
+    void owned_series_are_thinned(const Series& t, const Series& v)
+    {
+        std::vector<double> x(kN), y(kN);
+        for (int i = 0; i < kN; ++i)
+        {
+            x[i] = i;
+            y[i] = std::cos(i * 0.001);
+        }
+
+        Figure fig(480, 360);
+        fig.plot(x, y, Color::Green(), 1.f, "owned");
+        fig.plot(t, v, Color::Red(), 1.f, "mapped");
+        fig.memory_budget(fig.memory_usage().commands() - 1, MemoryPolicy::DecimateOldest);
+
+        const MemoryUsage mu = fig.memory_usage();
+        MPOCV_CHECK(mu.series.size() == 2);
+        if (mu.series.size() != 2) return;
+        MPOCV_CHECK(mu.series[0].label == "owned" && mu.series[0].points == kN / 2 + 1);
+        MPOCV_CHECK(mu.series[1].label == "mapped" && mu.series[1].points == static_cast<size_t>(kN));
+        MPOCV_CHECK(mu.series[1].bytes < sizeof(PlotCommand) + 256);
+    }
+
+    /// Line k lies at y = k; every hit must name a command whose label matches its y.
+    void picks_follow_dropped_commands()
+    {
+        const std::vector<double> x{ 0.0, 1.0, 2.0, 3.0 };
+        Figure fig(480, 360);
+        auto add = [&](int k) { fig.plot(x, std::vector<double>(x.size(), k), Color::Blue(), 1.f, std::to_string(k)); };
+        for (int k = 0; k < 8; ++k) add(k);
+        fig.render();
+        MPOCV_CHECK(fig.pick(0, 0, 1e6).found);   /* builds the index */
+
+        fig.memory_budget(fig.memory_usage().commands() - 1, MemoryPolicy::DropOldest);
+        for (int k = 8; k < 20; ++k)
+        {
+            add(k);   /* each push drops the oldest line */
+            fig.pick(0, 0, 1e6);
+        }
+
+        const MemoryUsage mu = fig.memory_usage();
+        MPOCV_CHECK(mu.series.size() == 7 && mu.series.front().label == "13");
+        size_t hits = 0;
+        bool consistent = true;
+        for (int py = 0; py < 360; py += 2)
+            for (int px = 0; px < 480; px += 8)
+            {
+                const PickResult r = fig.pick(px, py, 3.0);
+                if (!r.found) continue;
+                ++hits;
+                consistent = consistent && r.command < mu.series.size()
+                    && std::stoi(mu.series[r.command].label) == static_cast<int>(r.y);
+            }
+        MPOCV_CHECK(hits > 0);
+        MPOCV_CHECK(consistent);
+    }
+} // namespace
+
+int main()
+{
+    const fs::path raw = fs::temp_directory_path() / "mpocv_test_budget.raw";
+    mpocv_test::write_raw(raw, kN, [](int i) { return std::sin(i * 0.001); });
+    const Series t = load_raw(raw.string(), SampleType::Float32, 2, 0);   /* mapped views */
+    const Series v = load_raw(raw.string(), SampleType::Float32, 2, 1);
+    MPOCV_CHECK(t.size() == static_cast<size_t>(kN) && v.size() == static_cast<size_t>(kN));
+
+    mapped_series_are_dropped_not_copied(t, v);
+    owned_series_are_thinned(t, v);
+    picks_follow_dropped_commands();
+
+    fs::remove(raw);
+    return mpocv_test_result();
+}
@@ -0,0 +1,286 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+// MjpegServer over loopback: the multipart stream carries each published
+// frame; a client that stops reading neither blocks publish() nor misses the
+// newest frame; max_clients is enforced; stop() disconnects and joins.
+// Figure::stream_mjpeg() serves real JPEGs. POSIX sockets only.
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <csignal>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "figure.h"
+#include "mjpeg_server.h"
+#include "test_check.h"
+
+using namespace mpocv;
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int kTimeoutS = 5;   ///< Longest a read may block before the test gives up.
+
+    /// Connected loopback client that has sent its request (unless @p send_request is false); -1 on failure.
+    int connect_client(int port, bool send_request = true)
+    {
+        const int s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (s < 0) return -1;
+        timeval tv{ kTimeoutS, 0 };
+        setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        const char request[] = "GET / HTTP/1.0\r\n\r\n";
+        if (connect(s, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            (send_request && send(s, request, sizeof(request) - 1, 0) != static_cast<ssize_t>(sizeof(request) - 1)))
+        {
+            close(s);
+            return -1;
+        }
+        return s;
+    }
+
+    /// Buffered reader over a client socket.
+    struct Stream
+    {
+        int         sock;
+        std::string buf;
+        bool        eof{ false };   ///< The server closed the connection (rather than a timeout).
+
+        /// Reads until @p token is buffered; returns everything before it and consumes both.
+        bool until(const std::string& token, std::string& head)
+        {
+            size_t at;
+            while ((at = buf.find(token)) == std::string::npos)
+                if (!more()) return false;
+            head = buf.substr(0, at);
+            buf.erase(0, at + token.size());
+            return true;
+        }
+
+        bool take(size_t n, std::string& out)
+        {
+            while (buf.size() < n)
+                if (!more()) return false;
+            out = buf.substr(0, n);
+            buf.erase(0, n);
+            return true;
+        }
+
+        bool more()
+        {
+            char chunk[65536];
+            const ssize_t n = recv(sock, chunk, sizeof(chunk), 0);
+            eof = n == 0 || (n < 0 && errno == ECONNRESET);
+            if (n <= 0) return false;
+            buf.append(chunk, static_cast<size_t>(n));
+            return true;
+        }
+
+        bool header(std::string& head) { return until("\r\n\r\n", head); }
+
+        /// Next multipart frame; checks boundary and headers on the way.
+        bool part(std::string& jpeg)
+        {
+            std::string head, crlf;
+            if (!until("\r\n\r\n", head)) return false;
+            MPOCV_CHECK(head.rfind("--mpocvframe\r\nContent-Type: image/jpeg\r\n", 0) == 0);
+            const size_t at = head.find("Content-Length: ");
+            if (at == std::string::npos) return false;
+            const size_t n = std::strtoul(head.c_str() + at + 16, nullptr, 10);
+            return take(n, jpeg) && take(2, crlf) && crlf == "\r\n";
+        }
+    };
+
+    /// A frame of @p n bytes of @p fill (the fill byte identifies the frame).
+    MjpegServer::Frame make_frame(MjpegServer& server, size_t n, char fill)
+    {
+        MjpegServer::Frame f = server.acquire();
+        f->assign(n, static_cast<uint8_t>(fill));
+        return f;
+    }
+
+    void publish(MjpegServer& server, size_t n, char fill) { server.publish(make_frame(server, n, fill)); }
+
+    bool wait_for_clients(const MjpegServer& server, int n)
+    {
+        const auto deadline = Clock::now() + std::chrono::seconds(kTimeoutS);
+        while (server.clients() != n && Clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        return server.clients() == n;
+    }
+
+    /// Port 0 on loopback: the response header, then one part per published frame.
+    void streams_header_and_parts()
+    {
+        MjpegServer server;
+        MPOCV_CHECK(server.start(0, "127.0.0.1"));
+        MPOCV_CHECK(server.running() && server.port() > 0);
+        publish(server, 1000, 'a');   /* before the client: it still gets the latest */
+
+        Stream c{ connect_client(server.port()), {} };
+        MPOCV_CHECK(c.sock >= 0);
+        std::string head, jpeg;
+        MPOCV_CHECK(c.header(head));
+        MPOCV_CHECK(head.rfind("HTTP/1.0 200 OK\r\n", 0) == 0);
+        MPOCV_CHECK(head.find("Content-Type: multipart/x-mixed-replace; boundary=mpocvframe") != std::string::npos);
+        MPOCV_CHECK(c.part(jpeg) && jpeg == std::string(1000, 'a'));
+
+        publish(server, 3, 'b');
+        MPOCV_CHECK(c.part(jpeg) && jpeg == "bbb");
+        close(c.sock);
+        server.stop();
+    }
+
+    /// A client that stops reading holds up neither publish() nor itself: it resumes at the newest frame.
+    void stalled_client_gets_latest()
+    {
+        constexpr int kFrames = 40;
+        constexpr size_t kBytes = size_t(4) << 20;   /* far more than the socket buffers hold */
+
+        MjpegServer server;
+        MPOCV_CHECK(server.start(0, "127.0.0.1"));
+        Stream c{ connect_client(server.port()), {} };
+        MPOCV_CHECK(c.sock >= 0 && wait_for_clients(server, 1));
+
+        Clock::duration in_publish{};
+        for (int i = 0; i < kFrames; ++i)
+        {
+            MjpegServer::Frame f = make_frame(server, kBytes, static_cast<char>('A' + i));
+            const auto t0 = Clock::now();
+            server.publish(std::move(f));
+            in_publish += Clock::now() - t0;
+        }
+        const double publish_ms = std::chrono::duration<double, std::milli>(in_publish).count();
+        MPOCV_CHECK(publish_ms < 500.0);
+
+        std::string head, jpeg;
+        MPOCV_CHECK(c.header(head));
+        int parts = 0;
+        char last = 0;
+        bool ordered = true;
+        while (last != 'A' + kFrames - 1 && c.part(jpeg))
+        {
+            ++parts;
+            ordered = ordered && jpeg.size() == kBytes && jpeg[0] > last && jpeg.back() == jpeg[0];
+            last = jpeg[0];
+        }
+        MPOCV_CHECK(last == 'A' + kFrames - 1);
+        MPOCV_CHECK(ordered);
+        MPOCV_CHECK(parts < kFrames);   /* frames in between were skipped */
+        close(c.sock);
+        server.stop();
+    }
+
+    /// Connections beyond max_clients are closed right away; existing clients keep streaming.
+    void max_clients_is_enforced()
+    {
+        MjpegServer server;
+        MPOCV_CHECK(server.start(0, "127.0.0.1", 1));
+        Stream a{ connect_client(server.port()), {} };
+        MPOCV_CHECK(a.sock >= 0 && wait_for_clients(server, 1));
+
+        Stream b{ connect_client(server.port(), false), {} };
+        MPOCV_CHECK(b.sock < 0 || (!b.more() && b.eof && b.buf.empty()));   /* closed without a response */
+        MPOCV_CHECK(server.clients() == 1);
+
+        publish(server, 16, 'x');
+        std::string head, jpeg;
+        MPOCV_CHECK(a.header(head) && a.part(jpeg) && jpeg == std::string(16, 'x'));
+        if (b.sock >= 0) close(b.sock);
+        close(a.sock);
+        server.stop();
+    }
+
+    /// stop() disconnects clients waiting for a frame, blocked in send() or in recv(), and joins them.
+    void stop_joins_clients()
+    {
+        MjpegServer server;
+        MPOCV_CHECK(server.start(0, "127.0.0.1"));
+        Stream stalled{ connect_client(server.port()), {} };
+        Stream waiting{ connect_client(server.port()), {} };
+        Stream silent{ connect_client(server.port(), false), {} };
+        MPOCV_CHECK(stalled.sock >= 0 && waiting.sock >= 0 && silent.sock >= 0 && wait_for_clients(server, 3));
+
+        publish(server, size_t(16) << 20, 's');   /* the stalled client blocks in send() */
+        std::string head, jpeg;
+        MPOCV_CHECK(waiting.header(head) && waiting.part(jpeg));   /* then waits for the next frame */
+
+        const auto t0 = Clock::now();
+        server.stop();
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        MPOCV_CHECK(ms < 2000.0);
+        MPOCV_CHECK(!server.running() && server.clients() == 0);
+
+        for (Stream* c : { &stalled, &waiting, &silent })
+        {
+            while (c->more()) c->buf.clear();
+            MPOCV_CHECK(c->eof);
+            close(c->sock);
+        }
+        server.stop();   /* repeated stop() is harmless */
+        MPOCV_CHECK(server.start(0, "127.0.0.1"));
+        server.stop();
+    }
+
+    /// Figure::stream_mjpeg(): render() sends a JPEG of the canvas.
+    void figure_streams_jpeg()
+    {
+        Figure fig(64, 48);
+        MPOCV_CHECK(fig.stream_mjpeg(0));
+        MPOCV_CHECK(fig.stream_port() > 0);
+        Stream c{ connect_client(fig.stream_port()), {} };
+        MPOCV_CHECK(c.sock >= 0);
+
+        /* render() sends nothing until the client is counted, then the current frame once */
+        std::string head, jpeg;
+        const auto deadline = Clock::now() + std::chrono::seconds(kTimeoutS);
+        timeval quick{ 0, 20000 };
+        setsockopt(c.sock, SOL_SOCKET, SO_RCVTIMEO, &quick, sizeof(quick));
+        while (c.buf.find("Content-Length") == std::string::npos && Clock::now() < deadline)
+        {
+            fig.render();
+            c.more();
+        }
+        timeval slow{ kTimeoutS, 0 };
+        setsockopt(c.sock, SOL_SOCKET, SO_RCVTIMEO, &slow, sizeof(slow));
+        MPOCV_CHECK(c.header(head) && c.part(jpeg));
+        MPOCV_CHECK(jpeg.size() > 4 && static_cast<uint8_t>(jpeg[0]) == 0xFF && static_cast<uint8_t>(jpeg[1]) == 0xD8);
+        MPOCV_CHECK(jpeg.size() > 4 && static_cast<uint8_t>(jpeg[jpeg.size() - 2]) == 0xFF
+            && static_cast<uint8_t>(jpeg.back()) == 0xD9);
+        close(c.sock);
+        fig.stop_stream();
+        MPOCV_CHECK(fig.stream_port() == 0);
+    }
+} // namespace
+
+int main()
+{
+    std::signal(SIGPIPE, SIG_IGN);   /* a refused client must not end the test */
+    streams_header_and_parts();
+    stalled_client_gets_latest();
+    max_clients_is_enforced();
+    stop_joins_clients();
+    figure_streams_jpeg();
+    return mpocv_test_result();
+}
@@ -0,0 +1,133 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+// MpscQueue behaviour: capacity rounding, FIFO order, drop counting on a
+// full ring, and concurrent producers (no loss, per-producer order, every
+// failed push counted).
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "mpsc_queue.h"
+#include "test_check.h"
+
+using namespace mpocv;
+
+namespace
+{
+    constexpr int      kProducers = 4;
+    constexpr uint64_t kPerProducer = 200000;
+
+    uint64_t tag(uint64_t producer, uint64_t seq) { return producer << 32 | seq; }
+
+    void single_thread()
+    {
+        MPOCV_CHECK(MpscQueue<int>(0).capacity() == 2);
+        MPOCV_CHECK(MpscQueue<int>(5).capacity() == 8);
+
+        MpscQueue<int> q(4);
+        int v = -1;
+        MPOCV_CHECK(!q.try_pop(v));
+        for (int i = 0; i < 4; ++i) MPOCV_CHECK(q.try_push(i));
+        MPOCV_CHECK(!q.try_push(99));
+        MPOCV_CHECK(q.dropped() == 1);
+        for (int i = 0; i < 4; ++i) MPOCV_CHECK(q.try_pop(v) && v == i);
+        MPOCV_CHECK(!q.try_pop(v));
+
+        /* wrap around the ring several times */
+        for (int i = 0; i < 100; ++i)
+        {
+            MPOCV_CHECK(q.try_push(i));
+            MPOCV_CHECK(q.try_pop(v) && v == i);
+        }
+        MPOCV_CHECK(q.dropped() == 1);
+    }
+
+    void releases_popped_values()
+    {
+        MpscQueue<std::shared_ptr<int>> q(2);
+        auto p = std::make_shared<int>(7);
+        MPOCV_CHECK(q.try_push(p));
+        std::shared_ptr<int> out;
+        MPOCV_CHECK(q.try_pop(out) && *out == 7);
+        out.reset();
+        MPOCV_CHECK(p.use_count() == 1);   /* the slot no longer holds a reference */
+
+        MpscQueue<std::unique_ptr<int>> m(2);
+        MPOCV_CHECK(m.try_push(std::make_unique<int>(3)));
+        std::unique_ptr<int> u;
+        MPOCV_CHECK(m.try_pop(u) && u && *u == 3);
+    }
+
+    /// Producers run against a draining consumer; with @p retry nothing may be lost.
+    void concurrent(size_t capacity, bool retry)
+    {
+        MpscQueue<uint64_t> q(capacity);
+        std::atomic<uint64_t> pushed{ 0 };
+        std::atomic<int> running{ kProducers };
+        std::vector<std::thread> producers;
+        for (int p = 0; p < kProducers; ++p)
+        {
+            producers.emplace_back([&, p] {
+                uint64_t ok = 0;
+                for (uint64_t i = 0; i < kPerProducer; ++i)
+                {
+                    if (q.try_push(tag(p, i))) ++ok;
+                    else if (retry) { --i; std::this_thread::yield(); }
+                }
+                pushed += ok;
+                --running;
+            });
+        }
+
+        std::vector<int64_t> last(kProducers, -1);
+        uint64_t received = 0;
+        bool ordered = true;
+        auto consume = [&](uint64_t v) {
+            const uint64_t p = v >> 32;
+            const int64_t seq = static_cast<int64_t>(v & 0xffffffffu);
+            if (p >= kProducers || seq <= last[p]) ordered = false;
+            else last[p] = seq;
+            ++received;
+        };
+
+        uint64_t v = 0;
+        while (running.load() > 0)
+        {
+            if (q.try_pop(v)) consume(v);
+            else std::this_thread::yield();
+        }
+        for (auto& t : producers) t.join();
+        while (q.try_pop(v)) consume(v);   /* everything pushed before the producers finished */
+
+        const uint64_t attempts = kProducers * kPerProducer;
+        MPOCV_CHECK(ordered);
+        MPOCV_CHECK(received == pushed.load());
+        if (retry)
+        {
+            MPOCV_CHECK(received == attempts);
+            for (int p = 0; p < kProducers; ++p) MPOCV_CHECK(last[p] == static_cast<int64_t>(kPerProducer) - 1);
+        }
+        else
+        {
+            MPOCV_CHECK(received + q.dropped() == attempts);
+        }
+    }
+} // namespace
+
+int main()
+{
+    single_thread();
+    releases_popped_values();
+    concurrent(1024, true);   /* lossless: producers retry on a full ring */
+    concurrent(64, false);    /* lossy: a small ring drops, and every drop is counted */
+    return mpocv_test_result();
+}
@@ -0,0 +1,108 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+// render_progressive(): the finished sequence, whether drawn in one call or
+// one pass at a time, is pixel-identical to render(), and every completed
+// pass reaches the canvas.
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "figure.h"
+#include "test_check.h"
+
+using namespace mpocv;
+
+namespace
+{
+    constexpr int kN = 600000;   ///< Line points; enough for several passes.
+
+    /// Same content for every figure: a dense line, markers, text, legend and labels.
+    void fill(Figure& fig)
+    {
+        std::vector<double> x(kN), y(kN);
+        for (int i = 0; i < kN; ++i)
+        {
+            x[i] = i * 1e-3;
+            y[i] = std::sin(x[i]) + 0.2 * std::sin(x[i] * 37.0);
+        }
+        fig.plot(x, y, Color::Blue(), 1.f, "signal");
+        fig.scatter({ 50.0, 150.0, 450.0 }, { 0.5, -0.5, 1.0 }, Color::Red(), 4.f, "marks");
+        fig.text(300.0, 1.1, "peak");
+        fig.title("progressive");
+        fig.xlabel("t");
+        fig.legend(true);
+    }
+
+    bool same_pixels(const cv::Mat& a, const cv::Mat& b)
+    {
+        return a.size() == b.size() && a.type() == b.type() && cv::norm(a, b, cv::NORM_INF) == 0.0;
+    }
+
+    /// An unlimited budget finishes every pass in one call.
+    void one_call_matches_render(const cv::Mat& ref)
+    {
+        Figure fig(640, 480);
+        fill(fig);
+        const RenderProgress p = fig.render_progressive(std::numeric_limits<double>::infinity());
+        MPOCV_CHECK(p.complete);
+        MPOCV_CHECK(p.passes > 1 && p.pass == p.passes);
+        MPOCV_CHECK(same_pixels(fig.front(), ref));
+    }
+
+    /// A zero budget stops after each chunk; each completed pass replaces the canvas.
+    void stepped_passes_match_render(const cv::Mat& ref)
+    {
+        Figure fig(640, 480);
+        fill(fig);
+        const cv::Mat blank = fig.front().clone();
+
+        RenderProgress p;
+        int shown = 0;
+        bool pass_on_canvas = true;
+        for (int calls = 0; !p.complete && calls < 100000; ++calls)
+        {
+            p = fig.render_progressive(0.0);
+            if (p.pass > shown)
+            {
+                shown = p.pass;
+                pass_on_canvas = pass_on_canvas && !same_pixels(fig.front(), blank);
+            }
+        }
+        MPOCV_CHECK(p.complete);
+        MPOCV_CHECK(shown == p.passes);
+        MPOCV_CHECK(pass_on_canvas);
+        MPOCV_CHECK(same_pixels(fig.front(), ref));
+    }
+
+    /// render() finishes a sequence that is still running.
+    void render_finishes_sequence(const cv::Mat& ref)
+    {
+        Figure fig(640, 480);
+        fill(fig);
+        fig.render_progressive(0.0);
+        fig.render();
+        MPOCV_CHECK(same_pixels(fig.front(), ref));
+    }
+} // namespace
+
+int main()
+{
+    Figure reference(640, 480);
+    fill(reference);
+    reference.render();
+    const cv::Mat ref = reference.front().clone();
+
+    one_call_matches_render(ref);
+    stepped_passes_match_render(ref);
+    render_finishes_sequence(ref);
+    return mpocv_test_result();
+}
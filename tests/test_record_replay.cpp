@@ -0,0 +1,97 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+// record() -> replay() round trip: same pixels, compact sample types stay
+// compact on disk, replayed series are views, and a damaged file is rejected
+// without touching the figure.
+
+#include <cmath>
+#include <filesystem>
+#include <vector>
+
+#include "figure.h"
+#include "series_io.h"
+#include "test_check.h"
+#include "test_data.h"
+
+using namespace mpocv;
+
+namespace
+{
+    namespace fs = std::filesystem;
+
+    constexpr int kGrid = 256;   ///< Side of the float32 image.
+    constexpr int kN = 1000;     ///< Points per series.
+
+    /// Figure with Float64 (line), UInt8 (scatter colors), Float32 (image) and strided Float32 (raw channel) series.
+    void build(Figure& fig, const Series& raw_channel)
+    {
+        std::vector<double> x(kN), y(kN), v(kN);
+        for (int i = 0; i < kN; ++i)
+        {
+            x[i] = i * 0.01;
+            y[i] = std::sin(x[i]);
+            v[i] = x[i];
+        }
+        cv::Mat field(kGrid, kGrid, CV_32FC1);
+        for (int r = 0; r < kGrid; ++r)
+            for (int c = 0; c < kGrid; ++c)
+                field.at<float>(r, c) = static_cast<float>(std::sin(0.05 * c) * std::cos(0.07 * r));
+
+        fig.image(field, 0.0, -1.0, 10.0, 1.0, Colormap::Jet, -1.0, 1.0);
+        fig.plot(x, y, Color::Blue(), 2.0f, "line");
+        fig.scatter_colored(x, y, v, {}, Colormap::Viridis, 0.0, 0.0, "colored");
+        fig.plot(Series(x), raw_channel, Color::Red(), 1.0f, "raw");
+        fig.text(5.0, 0.5, "round trip", Color::Black());
+        fig.title("record / replay");
+        fig.legend(true);
+    }
+} // namespace
+
+int main()
+{
+    const fs::path dir = fs::temp_directory_path();
+    const fs::path raw = dir / "mpocv_test_channels.raw";
+    const fs::path rec = dir / "mpocv_test_round_trip.mpocv";
+
+    mpocv_test::write_raw(raw, kN, [](int i) { return 0.5 * std::cos(i * 0.01); });
+    const Series channel = load_raw(raw.string(), SampleType::Float32, 2, 1);   /* strided view */
+    MPOCV_CHECK(channel.size() == static_cast<size_t>(kN));
+
+    Figure a(480, 360);
+    build(a, channel);
+    a.render();
+    MPOCV_CHECK(a.record(rec.string()));
+
+    /* replay draws exactly what was recorded */
+    Figure b(480, 360);
+    MPOCV_CHECK(b.replay(rec.string()));
+    b.render();
+    MPOCV_CHECK(cv::norm(a.front(), b.front(), cv::NORM_INF) == 0.0);
+
+    /* samples keep their type on disk: the float image alone would be 512 KiB as f64 */
+    const uintmax_t widened = sizeof(double) * (kGrid * kGrid + 7 * kN);
+    const uintmax_t native = sizeof(float) * kGrid * kGrid + sizeof(double) * 5 * kN + kN + sizeof(float) * kN;
+    MPOCV_CHECK(fs::file_size(rec) < widened);
+    MPOCV_CHECK(fs::file_size(rec) < native + 16 * 1024);
+
+    /* replayed series view the mapping: nothing but the command record is owned */
+    for (const auto& s : b.memory_usage().series)
+        MPOCV_CHECK(s.bytes < sizeof(PlotCommand) + 256);
+
+    /* a truncated file is rejected and the figure keeps its commands */
+    fs::resize_file(rec, fs::file_size(rec) / 2);
+    Figure c(480, 360);
+    c.plot({ 0.0, 1.0 }, { 0.0, 1.0 });
+    MPOCV_CHECK(!c.replay(rec.string()));
+    MPOCV_CHECK(c.memory_usage().series.size() == 1);
+
+    fs::remove(rec);
+    fs::remove(raw);
+    return mpocv_test_result();
+}
@@ -0,0 +1,246 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+// ShmPublisher / ShmReader behaviour: frames round-trip with their geometry,
+// oversized frames are refused, the segment disappears with the publisher,
+// a slot caught mid-write is skipped, a copy of a publishing Figure does not
+// take the ring along, and a reader racing the writer (in a thread and in
+// another process) never returns a torn frame or goes backwards.
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "figure.h"
+#include "shm_ring.h"
+#include "test_check.h"
+
+using namespace mpocv;
+
+namespace
+{
+    constexpr int kRows = 480, kCols = 640;
+    constexpr int kFrames = 5000;
+    constexpr int kPatterns = 3;   ///< Distinct fills; coprime with the slot counts used below.
+
+    std::string ring_name(const char* what)
+    {
+        return std::string("mpocv_test_") + what + "_" + std::to_string(static_cast<long>(getpid()));
+    }
+
+    /// Fill byte of frame n. Frames sharing a slot always differ, so a torn copy mixes two values.
+    unsigned char pattern(uint64_t n) { return static_cast<unsigned char>(1 + n % kPatterns); }
+
+    void fill(cv::Mat& m, uint64_t n) { m.setTo(cv::Scalar::all(pattern(n))); }
+
+    /// True if every byte of @p m is the fill of frame n and the geometry matches.
+    bool intact(const cv::Mat& m, uint64_t n)
+    {
+        if (m.rows != kRows || m.cols != kCols || m.type() != CV_8UC3) return false;
+        const unsigned char v = pattern(n);
+        for (int r = 0; r < m.rows; ++r)
+        {
+            const unsigned char* p = m.ptr(r);
+            for (size_t i = 0; i < m.cols * m.elemSize(); ++i)
+                if (p[i] != v) return false;
+        }
+        return true;
+    }
+
+    void basics()
+    {
+        const std::string name = ring_name("basics");
+        MPOCV_CHECK(!ShmReader::open(name));
+
+        auto pub = ShmPublisher::create(name, kRows * kCols * 3, 3);
+        MPOCV_CHECK(pub != nullptr);
+        if (!pub) return;
+        auto reader = ShmReader::open(name);
+        MPOCV_CHECK(reader != nullptr);
+        if (!reader) return;
+
+        cv::Mat out;
+        MPOCV_CHECK(reader->read_latest(out) == 0);   /* nothing published yet */
+
+        /* a non-contiguous ROI is published row by row */
+        cv::Mat big(kRows + 10, kCols + 10, CV_8UC3);
+        cv::Mat roi = big(cv::Rect(5, 5, kCols, kRows));
+        fill(roi, 1);
+        MPOCV_CHECK(pub->publish(roi));
+        MPOCV_CHECK(pub->frames() == 1);
+        MPOCV_CHECK(reader->read_latest(out) == 1 && intact(out, 1));
+        MPOCV_CHECK(reader->read_latest(out, 1) == 0);   /* nothing newer */
+
+        /* smaller frames and other types fit; larger ones are refused */
+        cv::Mat gray(kRows, kCols, CV_8UC1, cv::Scalar(9));
+        MPOCV_CHECK(pub->publish(gray));
+        MPOCV_CHECK(reader->read_latest(out, 1) == 2 && out.type() == CV_8UC1 && out.rows == kRows);
+        MPOCV_CHECK(!pub->publish(cv::Mat(kRows + 1, kCols, CV_8UC3, cv::Scalar(0))));
+        MPOCV_CHECK(pub->frames() == 2);
+
+        /* the publisher unlinks the segment; an existing mapping stays readable */
+        pub.reset();
+        MPOCV_CHECK(!ShmReader::open(name));
+        MPOCV_CHECK(reader->read_latest(out) == 2);
+    }
+
+    /// Marks the newest slot as being written, as a publisher lapping the reader would.
+    /// Relies on the segment layout in src/shm_ring.cpp: a 64-byte ring header, then slot 0
+    /// whose header starts with its seq.
+    void mid_write_slot_is_skipped()
+    {
+        const std::string name = ring_name("midwrite");
+        auto pub = ShmPublisher::create(name, kRows * kCols * 3, 2);
+        auto reader = ShmReader::open(name);
+        MPOCV_CHECK(pub && reader);
+        if (!pub || !reader) return;
+
+        cv::Mat frame(kRows, kCols, CV_8UC3);
+        fill(frame, 1);
+        MPOCV_CHECK(pub->publish(frame));   /* frame 1 lands in slot 0 */
+
+        const int fd = shm_open(("/" + name).c_str(), O_RDWR, 0);
+        MPOCV_CHECK(fd >= 0);
+        if (fd < 0) return;
+        void* base = mmap(nullptr, 128, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        MPOCV_CHECK(base != MAP_FAILED);
+        if (base == MAP_FAILED) return;
+        auto& seq = *reinterpret_cast<std::atomic<uint64_t>*>(static_cast<char*>(base) + 64);
+
+        cv::Mat out;
+        const uint64_t even = seq.load();
+        MPOCV_CHECK((even & 1) == 0);
+        seq.store(even + 1);
+        MPOCV_CHECK(reader->read_latest(out) == 0);
+        seq.store(even);
+        MPOCV_CHECK(reader->read_latest(out) == 1 && intact(out, 1));
+        munmap(base, 128);
+    }
+
+    /// The ring belongs to the figure that called publish_shm(), not to its copies.
+    void figure_copy_leaves_ring_behind()
+    {
+        const std::string name = ring_name("figure");
+        Figure a(64, 48);
+        MPOCV_CHECK(a.publish_shm(name));
+        {
+            Figure b(a);
+            b.render();   /* publishes nothing; destroying b must not unlink a's ring */
+        }
+        a.render();
+        auto reader = ShmReader::open(name);
+        MPOCV_CHECK(reader != nullptr);
+        cv::Mat out;
+        MPOCV_CHECK(reader && reader->read_latest(out) == 1 && out.rows == 48 && out.cols == 64);
+    }
+
+    /// A wider canvas_format() after publish_shm() still fits the slots.
+    void wider_format_keeps_publishing()
+    {
+        const std::string name = ring_name("format");
+        Figure fig(64, 48);
+        MPOCV_CHECK(fig.publish_shm(name));
+        fig.render();
+        fig.canvas_format(CanvasFormat::BGR16);
+        fig.render();
+        auto reader = ShmReader::open(name);
+        MPOCV_CHECK(reader != nullptr);
+        cv::Mat out;
+        MPOCV_CHECK(reader && reader->read_latest(out) == 2 && out.type() == CV_16UC3);
+        fig.canvas_format(CanvasFormat::BGRA8);
+        fig.render();
+        MPOCV_CHECK(reader && reader->read_latest(out, 2) == 3 && out.type() == CV_8UC4);
+    }
+
+    /// Pre-filled frames, so the writer publishes back to back and laps the reader often.
+    struct Frames
+    {
+        cv::Mat m[kPatterns];
+        Frames() { for (int i = 0; i < kPatterns; ++i) { m[i].create(kRows, kCols, CV_8UC3); fill(m[i], i); } }
+        const cv::Mat& operator[](uint64_t n) const { return m[n % kPatterns]; }
+    };
+
+    /// Reads until frame kFrames arrives, counting torn and out-of-order copies.
+    void read_all(ShmReader& reader, long& torn, long& backwards, uint64_t& last)
+    {
+        cv::Mat out;
+        uint64_t seen = 0;
+        while (seen < static_cast<uint64_t>(kFrames))
+        {
+            const uint64_t f = reader.read_latest(out, seen);
+            if (f == 0) continue;
+            if (f <= seen) ++backwards;
+            if (!intact(out, f)) ++torn;
+            seen = f;
+            last = f;
+        }
+    }
+
+    void reader_thread_races_writer()
+    {
+        const std::string name = ring_name("thread");
+        auto pub = ShmPublisher::create(name, kRows * kCols * 3, 2);   /* two slots: the writer laps often */
+        auto reader = ShmReader::open(name);
+        MPOCV_CHECK(pub && reader);
+        if (!pub || !reader) return;
+
+        long torn = 0, backwards = 0;
+        uint64_t last = 0;
+        std::thread t([&] { read_all(*reader, torn, backwards, last); });
+
+        const Frames frames;
+        for (uint64_t n = 1; n <= kFrames; ++n) MPOCV_CHECK(pub->publish(frames[n]));
+        t.join();
+
+        MPOCV_CHECK(torn == 0);
+        MPOCV_CHECK(backwards == 0);
+        MPOCV_CHECK(last == static_cast<uint64_t>(kFrames));
+    }
+
+    void reader_process_races_writer()
+    {
+        const std::string name = ring_name("process");
+        auto pub = ShmPublisher::create(name, kRows * kCols * 3, 2);
+        MPOCV_CHECK(pub != nullptr);
+        if (!pub) return;
+
+        const Frames frames;
+        const pid_t child = fork();
+        if (child == 0)
+        {
+            auto reader = ShmReader::open(name);
+            if (!reader) _exit(2);
+            long torn = 0, backwards = 0;
+            uint64_t last = 0;
+            read_all(*reader, torn, backwards, last);
+            _exit(torn == 0 && backwards == 0 && last == static_cast<uint64_t>(kFrames) ? 0 : 1);
+        }
+
+        for (uint64_t n = 1; n <= kFrames; ++n) pub->publish(frames[n]);
+        int status = 0;
+        waitpid(child, &status, 0);
+        MPOCV_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+} // namespace
+
+int main()
+{
+    basics();
+    mid_write_slot_is_skipped();
+    figure_copy_leaves_ring_behind();
+    wider_format_keeps_publishing();
+    reader_thread_races_writer();
+    reader_process_races_writer();
+    return mpocv_test_result();
+}
@@ -0,0 +1,96 @@
+// =============================================================================
+//  MatPlotOpenCV - Minimal 2D plotting library using OpenCV
+//  Copyright (c) 2025 Michael Hannan
+//
+//  This file is part of MatPlotOpenCV and is licensed under the BSD 3-Clause
+//  License. See the LICENSE file in the project root for full terms.
+// =============================================================================
+
+// Out-of-process viewer for Figure::publish_shm().
+//
+// Usage: mpocv_view [NAME] [--fps N]
+//
+// Maps the shared-memory ring NAME (default "mpocv") and shows its newest
+// frame in a highgui window, polling at up to --fps (default 60). The
+// producer never waits for this process: frames published faster than they
+// are shown are skipped. When the producer goes away or restarts, the viewer
+// keeps the last frame and reattaches to the new ring. Esc or q quits.
+
+#include <opencv2/highgui.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "shm_ring.h"
+
+using namespace mpocv;
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr auto kReattach = std::chrono::seconds(1);   ///< Idle time before looking for a new ring.
+}
+
+int main(int argc, char** argv)
+{
+    std::string name = "mpocv";
+    double fps = 60.0;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string a = argv[i];
+        if (a == "--fps" && i + 1 < argc) fps = std::atof(argv[++i]);
+        else if (a == "-h" || a == "--help")
+        {
+            std::cout << "usage: mpocv_view [NAME] [--fps N]\n";
+            return 0;
+        }
+        else name = a;
+    }
+    const int wait_ms = std::max(1, static_cast<int>(1000.0 / std::max(1.0, fps)));
+
+    std::unique_ptr<ShmReader> reader;
+    cv::Mat frame;
+    uint64_t seen = 0;
+    auto last_frame = Clock::now() - kReattach;
+    bool waiting_noted = false;
+
+    cv::namedWindow(name, cv::WINDOW_AUTOSIZE);
+    for (;;)
+    {
+        /* (re)attach when there is no ring yet or the current one went quiet */
+        if (!reader || Clock::now() - last_frame >= kReattach)
+        {
+            if (auto r = ShmReader::open(name))
+            {
+                reader = std::move(r);
+                seen = 0;
+                waiting_noted = false;
+            }
+            else if (!reader && !waiting_noted)
+            {
+                std::cerr << "mpocv_view: waiting for shared-memory ring '" << name << "'\n";
+                waiting_noted = true;
+            }
+            last_frame = Clock::now();
+        }
+
+        if (reader)
+        {
+            if (const uint64_t f = reader->read_latest(frame, seen))
+            {
+                seen = f;
+                last_frame = Clock::now();
+                cv::imshow(name, frame);
+            }
+        }
+
+        const int key = cv::waitKey(wait_ms);
+        if (key == 27 || key == 'q') break;
+    }
+    return 0;
+}